@@ -0,0 +1,348 @@
+// =============================================================
+// Scintillator_Sipm_bench: benchmark de rendimiento sin visualización.
+//
+// Corre una carga fija (semilla fija, neutrones térmicos de la fuente
+// por defecto, salida en nivel summary) para cada ScintType y reporta
+// eventos/s, steps/s, fotones ópticos seguidos/s, pico de RSS y tiempo
+// de inicialización en JSON. Con --compare marca las regresiones
+// respecto a un JSON de referencia guardado.
+//
+// Cada tipo de centellador se mide en un proceso propio (la geometría
+// y las tablas de física se construyen una sola vez por proceso).
+// =============================================================
+#include "G4RunManagerFactory.hh"
+#include "G4UImanager.hh"
+#include "G4Version.hh"
+#include "Randomize.hh"
+
+// Usuario
+#include "ActionInitialization.hh"
+#include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
+#include "Profiler.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+
+const std::vector<std::pair<std::string, ScintType>> kScintTypes = {
+    { "PLASTIC", ScintType::PLASTIC },
+    { "BGO",     ScintType::BGO },
+    { "CSI",     ScintType::CSI },
+    { "LYSO",    ScintType::LYSO }
+};
+
+// Prefijo de la línea de resultado de cada proceso hijo
+const std::string kResultTag = "BENCH_RESULT ";
+
+// Métricas en el orden en que se escriben; higherIsBetter decide el
+// sentido de la regresión
+struct Metric
+{
+    const char* name;
+    G4bool higherIsBetter;
+};
+
+const std::vector<Metric> kMetrics = {
+    { "events_per_s",          true  },
+    { "steps_per_s",           true  },
+    { "optical_photons_per_s", true  },
+    { "peak_rss_mb",           false },
+    { "init_time_s",           false }
+};
+
+using Result = std::map<std::string, G4double>;
+
+G4double PeakRSSMegabytes()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.;   // Linux: kB
+}
+
+G4double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<G4double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// =============================================================
+// JSON
+// =============================================================
+std::string ResultToJson(const Result& result)
+{
+    std::ostringstream json;
+    json << "{";
+    for (std::size_t i = 0; i < kMetrics.size(); ++i) {
+        auto it = result.find(kMetrics[i].name);
+        json << (i ? ", " : "") << "\"" << kMetrics[i].name << "\": "
+             << (it != result.end() ? it->second : 0.);
+    }
+    json << "}";
+    return json.str();
+}
+
+// Lectura mínima del formato que escribe este mismo programa:
+// { "results": { "PLASTIC": {"events_per_s": 1.0, ...}, ... } }
+Result ParseResult(const std::string& json, const std::string& scint)
+{
+    Result result;
+
+    std::size_t begin = json.find("\"" + scint + "\"");
+    if (begin == std::string::npos) return result;
+    begin = json.find('{', begin);
+    const std::size_t end = json.find('}', begin);
+    if (begin == std::string::npos || end == std::string::npos) return result;
+
+    const std::string object = json.substr(begin, end - begin);
+    for (const auto& metric : kMetrics) {
+        const std::size_t key = object.find("\"" + std::string(metric.name) + "\"");
+        if (key == std::string::npos) continue;
+        const std::size_t colon = object.find(':', key);
+        result[metric.name] = std::strtod(object.c_str() + colon + 1, nullptr);
+    }
+    return result;
+}
+
+Result ParseChildResult(const std::string& line)
+{
+    // La línea del hijo es un objeto plano: se reutiliza el lector con una clave ficticia
+    return ParseResult("{\"child\": " + line.substr(kResultTag.size()) + "}", "child");
+}
+
+// =============================================================
+// Un tipo de centellador en este proceso
+// =============================================================
+Result RunBenchmark(ScintType scintType, G4int nEvents, G4int nThreads)
+{
+    const auto initStart = std::chrono::steady_clock::now();
+
+    auto* runManager = G4RunManagerFactory::CreateRunManager(
+        nThreads > 0 ? G4RunManagerType::Default : G4RunManagerType::Serial);
+    if (nThreads > 0)
+        runManager->SetNumberOfThreads(nThreads);
+
+    G4Random::setTheSeed(123456789);
+
+    auto* detector = new DetectorConstruction();
+    detector->SetScintType(scintType);
+    runManager->SetUserInitialization(detector);
+    runManager->SetUserInitialization(CreatePhysicsList(false, false));
+    runManager->SetUserInitialization(new ActionInitialization());
+    runManager->Initialize();
+
+    auto UImanager = G4UImanager::GetUIpointer();
+    UImanager->ApplyCommand("/control/verbose 0");
+    UImanager->ApplyCommand("/run/verbose 0");
+    UImanager->ApplyCommand("/event/verbose 0");
+    UImanager->ApplyCommand("/tracking/verbose 0");
+    UImanager->ApplyCommand("/output/level summary");
+
+    // Steps y fotones ópticos del perfil, sin lecturas de reloj por step
+    UImanager->ApplyCommand("/profile/level count");
+    UImanager->ApplyCommand("/profile/file none");
+
+    // Primer run vacío: las tablas de física se construyen aquí y
+    // cuentan como inicialización
+    runManager->BeamOn(0);
+    const G4double initTime = SecondsSince(initStart);
+
+    const auto runStart = std::chrono::steady_clock::now();
+    runManager->BeamOn(nEvents);
+    const G4double runTime = SecondsSince(runStart);
+
+    auto profiler = Profiler::Instance();
+
+    Result result;
+    result["events_per_s"]          = runTime > 0. ? nEvents / runTime : 0.;
+    result["steps_per_s"]           = runTime > 0. ? profiler->GetTotalSteps() / runTime : 0.;
+    result["optical_photons_per_s"] = runTime > 0. ? profiler->GetTotalOpticalPhotons() / runTime : 0.;
+    result["peak_rss_mb"]           = PeakRSSMegabytes();
+    result["init_time_s"]           = initTime;
+
+    delete runManager;
+    return result;
+}
+
+// =============================================================
+// Todos los tipos: un proceso hijo por centellador
+// =============================================================
+G4bool RunChild(const std::string& self, const std::string& scint,
+                G4int nEvents, G4int nThreads, Result& result)
+{
+    std::ostringstream command;
+    command << "\"" << self << "\" --scint " << scint << " -n " << nEvents;
+    if (nThreads > 0) command << " -t " << nThreads;
+
+    FILE* pipe = popen(command.str().c_str(), "r");
+    if (!pipe) return false;
+
+    G4bool found = false;
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), pipe)) {
+        const std::string line(buffer);
+        if (line.compare(0, kResultTag.size(), kResultTag) == 0) {
+            result = ParseChildResult(line);
+            found = true;
+        }
+    }
+    return pclose(pipe) == 0 && found;
+}
+
+// =============================================================
+// Comparación con la referencia
+// =============================================================
+G4int Compare(const std::map<std::string, Result>& results,
+              const std::string& baselineFile, G4double tolerance)
+{
+    std::ifstream in(baselineFile);
+    if (!in) {
+        std::cerr << "No se pudo leer la referencia " << baselineFile << "\n";
+        return 1;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string baselineJson = buffer.str();
+
+    G4int nRegressions = 0;
+    std::cerr << "\n=========== COMPARACIÓN CON " << baselineFile << " ===========\n";
+
+    for (const auto& entry : results) {
+        const Result baseline = ParseResult(baselineJson, entry.first);
+        if (baseline.empty()) {
+            std::cerr << entry.first << ": sin referencia\n";
+            continue;
+        }
+
+        for (const auto& metric : kMetrics) {
+            auto ref = baseline.find(metric.name);
+            auto now = entry.second.find(metric.name);
+            if (ref == baseline.end() || now == entry.second.end() || ref->second <= 0.)
+                continue;
+
+            const G4double change = (now->second - ref->second) / ref->second;
+            const G4bool regression = metric.higherIsBetter ? change < -tolerance
+                                                            : change >  tolerance;
+            if (regression) ++nRegressions;
+
+            std::fprintf(stderr, "%-8s %-22s %12.4g -> %12.4g  (%+6.1f%%)%s\n",
+                         entry.first.c_str(), metric.name, ref->second, now->second,
+                         100. * change, regression ? "  REGRESIÓN" : "");
+        }
+    }
+
+    std::cerr << (nRegressions ? "Regresiones: " + std::to_string(nRegressions) : std::string("Sin regresiones"))
+              << " (tolerancia " << 100. * tolerance << "%)\n";
+    return nRegressions ? 2 : 0;
+}
+
+void PrintUsage()
+{
+    std::cerr << "Uso: Scintillator_Sipm_bench [-n eventos] [-t nThreads] [--scint TIPO]\n"
+              << "                             [-o resultado.json] [--compare referencia.json] [--tolerance 0.10]\n"
+              << "  -n                 eventos por centellador (por defecto 200)\n"
+              << "  -t, --threads      hilos de trabajo (por defecto secuencial)\n"
+              << "  --scint TIPO       solo PLASTIC, BGO, CSI o LYSO (por defecto todos)\n"
+              << "  -o                 escribe el JSON en un archivo (por defecto stdout)\n"
+              << "  --compare          marca regresiones frente a un JSON anterior (código de salida 2)\n"
+              << "  --tolerance        variación relativa permitida (por defecto 0.10)\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    // ----------------------------------
+    // Argumentos de línea de comandos
+    // ----------------------------------
+    G4int nEvents = 200;
+    G4int nThreads = 0;
+    std::string scint;
+    std::string outputFile;
+    std::string baselineFile;
+    G4double tolerance = 0.10;
+
+    for (G4int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            nEvents = std::atoi(argv[++i]);
+        }
+        else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) {
+            nThreads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--scint" && i + 1 < argc) {
+            scint = argv[++i];
+        }
+        else if (arg == "-o" && i + 1 < argc) {
+            outputFile = argv[++i];
+        }
+        else if (arg == "--compare" && i + 1 < argc) {
+            baselineFile = argv[++i];
+        }
+        else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::atof(argv[++i]);
+        }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // Proceso hijo: un solo centellador, resultado en una línea marcada
+    if (!scint.empty()) {
+        for (const auto& type : kScintTypes) {
+            if (type.first != scint) continue;
+            const Result result = RunBenchmark(type.second, nEvents, nThreads);
+            std::cout << kResultTag << ResultToJson(result) << std::endl;
+            return 0;
+        }
+        std::cerr << "Centellador desconocido: " << scint << "\n";
+        return 1;
+    }
+
+    // ----------------------------------
+    // Todos los centelladores
+    // ----------------------------------
+    std::map<std::string, Result> results;
+    for (const auto& type : kScintTypes) {
+        std::cerr << ">>> Benchmark " << type.first << " (" << nEvents << " eventos)\n";
+        Result result;
+        if (!RunChild(argv[0], type.first, nEvents, nThreads, result)) {
+            std::cerr << "ERROR: falló el benchmark de " << type.first << "\n";
+            return 1;
+        }
+        results[type.first] = result;
+    }
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"geant4\": \"" << G4Version << "\",\n"
+         << "  \"events\": " << nEvents << ",\n"
+         << "  \"threads\": " << nThreads << ",\n"
+         << "  \"results\": {\n";
+    for (std::size_t i = 0; i < kScintTypes.size(); ++i) {
+        const std::string& name = kScintTypes[i].first;
+        json << "    \"" << name << "\": " << ResultToJson(results[name])
+             << (i + 1 < kScintTypes.size() ? ",\n" : "\n");
+    }
+    json << "  }\n}\n";
+
+    if (outputFile.empty()) {
+        std::cout << json.str();
+    }
+    else {
+        std::ofstream out(outputFile);
+        out << json.str();
+    }
+
+    return baselineFile.empty() ? 0 : Compare(results, baselineFile, tolerance);
+}
@@ -0,0 +1,84 @@
+// =============================================================
+// Scintillator_Sipm_scan: ejemplo del lector columnar.
+//
+// Recorre una columna de un archivo .scol directamente sobre el mmap
+// (sin copiar ni deserializar) e imprime filas, mínimo, máximo y
+// media. Solo depende de ColumnarReader, no de Geant4.
+//
+//     ./Scintillator_Sipm_scan output.scol SiPMData time_ns
+//     ./Scintillator_Sipm_scan output.scol          # lista de ntuples y columnas
+// =============================================================
+#include "ColumnarReader.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+template <typename T>
+void Scan(const ColumnarColumn<T>& column)
+{
+    double sum = 0.;
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+
+    for (const auto& chunk : column.chunks) {
+        for (std::uint64_t i = 0; i < chunk.size; ++i) {
+            const double value = static_cast<double>(chunk.data[i]);
+            sum += value;
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+    }
+
+    std::cout << "filas: " << column.size << " (" << column.chunks.size() << " bloques)\n";
+    if (column.size == 0) return;
+    std::cout << "mínimo: " << min << "\n"
+              << "máximo: " << max << "\n"
+              << "media:  " << sum / static_cast<double>(column.size) << "\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2 && argc != 4) {
+        std::cerr << "Uso: Scintillator_Sipm_scan archivo.scol [ntuple columna]\n";
+        return 1;
+    }
+
+    try {
+        ColumnarFile file(argv[1]);
+
+        if (argc == 2) {
+            for (const auto& ntuple : file.GetNtuples()) {
+                std::cout << ntuple.name << (ntuple.active ? "" : " (inactivo)") << "\n";
+                for (const auto& column : ntuple.columns)
+                    std::cout << "  " << column.name << " " << column.type << "\n";
+            }
+            return 0;
+        }
+
+        const std::string ntuple = argv[2];
+        const std::string columnName = argv[3];
+
+        // El tipo de la columna decide la vista (int32 o double)
+        for (const auto& info : file.GetNtuples()) {
+            if (info.name != ntuple) continue;
+            for (const auto& column : info.columns) {
+                if (column.name != columnName) continue;
+                if (column.type == 'I') Scan(file.GetColumn<std::int32_t>(ntuple, columnName));
+                else                    Scan(file.GetColumn<double>(ntuple, columnName));
+                return 0;
+            }
+        }
+        std::cerr << "No existe la columna " << ntuple << "." << columnName << "\n";
+        return 1;
+    }
+    catch (const std::exception& error) {
+        std::cerr << error.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef BatchRunManager_h
+#define BatchRunManager_h 1
+
+#include "G4RunManager.hh"
+
+#include <cstdint>
+#include <set>
+
+// =============================================================
+// G4RunManager secuencial con eventos numerados globalmente y una
+// semilla por evento.
+//
+// Con SetWorker(i, n) el proceso i de n solo simula su parte de cada
+// /run/beamOn N (rangos contiguos) y sus eventos conservan el número
+// global. Antes de cada evento el motor aleatorio se resiembra a
+// partir de (semilla maestra, run, evento global), así que el
+// resultado del evento no depende del número de procesos ni de qué
+// proceso lo simula.
+//
+// Con SetCheckpointInterval(K) cada /run/beamOn se simula en bloques
+// de K eventos, cada uno con su propia salida cerrada y sincronizada
+// en disco. Tras cada bloque se guarda el estado (<salida>.ckpt); un
+// trabajo reiniciado con la misma macro continúa desde el último
+// bloque completo y fusiona todos los bloques al final. Como la
+// semilla depende solo del evento global, (semilla maestra, run,
+// siguiente evento) es todo el estado aleatorio que hace falta. El
+// estado lleva el hash de la macro (SetCheckpointKey): el de otro
+// trabajo con la misma salida no se reutiliza, y FinishCheckpoints
+// lo borra cuando el trabajo termina sin interrupciones.
+// =============================================================
+class BatchRunManager : public G4RunManager
+{
+public:
+    explicit BatchRunManager(std::uint64_t masterSeed);
+    ~BatchRunManager() override = default;
+
+    // Proceso index de nWorkers (por defecto 0 de 1: todos los eventos)
+    void SetWorker(G4int index, G4int nWorkers);
+
+    // Eventos por bloque (0: sin puntos de control)
+    void SetCheckpointInterval(G4int nEvents) { fCheckpointInterval = nEvents; }
+
+    // Identifica el trabajo en el estado guardado (hash de la macro)
+    void SetCheckpointKey(const G4String& macroFile);
+
+    // Fin de la macro: borra los .ckpt si todos los runs se completaron
+    void FinishCheckpoints();
+
+    void BeamOn(G4int n_event, const char* macroFile = nullptr, G4int n_select = -1) override;
+
+    // Primer evento global del bloque (o run) en curso
+    G4int GetEventOffset() const { return fEventOffset; }
+
+protected:
+    G4Event* GenerateEvent(G4int i_event) override;
+
+private:
+    void BeamOnWithCheckpoints(G4int runIndex, G4int firstEvent, G4int nEvents,
+                               const char* macroFile, G4int n_select);
+
+    std::uint64_t fMasterSeed;
+    G4int fWorkerIndex = 0;
+    G4int fNWorkers = 1;
+    G4int fCheckpointInterval = 0;
+    std::uint64_t fCheckpointKey = 0;
+    std::set<G4String> fStateFiles;       // .ckpt usados por la macro
+    G4bool fCheckpointsComplete = true;
+
+    G4int fRunIndex = 0;      // /run/beamOn de la macro (no cuenta bloques)
+    G4int fCurrentRun = 0;
+    G4int fEventOffset = 0;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef CaptureBiasingOperator_h
+#define CaptureBiasingOperator_h 1
+
+#include "G4VBiasingOperator.hh"
+
+#include <map>
+
+class G4BOptnChangeCrossSection;
+class DetectorConstruction;
+
+// =============================================================
+// Biasing de ocurrencia de la captura del neutrón primario (--bias):
+// en los volúmenes a los que se asocia, la sección eficaz de los
+// procesos de captura (neutronInelastic, que incluye la 10B(n,a), y
+// nCapture) se multiplica por un factor. No hay clones: cada evento
+// sigue una sola historia y el peso del neutrón acumula el cociente
+// de probabilidades (1/factor al interaccionar, >1 al atravesar sin
+// interaccionar), que heredan sus secundarios. El peso final del
+// primario es el peso del evento.
+// Solo el primario: los neutrones secundarios no se sesgan.
+// El factor (/det/biasFactor) se lee del detector al empezar cada run.
+// =============================================================
+class CaptureBiasingOperator : public G4VBiasingOperator
+{
+public:
+    explicit CaptureBiasingOperator(const DetectorConstruction* detector);
+    ~CaptureBiasingOperator() override;
+
+    void StartRun() override;
+
+private:
+    G4VBiasingOperation* ProposeOccurenceBiasingOperation(
+        const G4Track* track, const G4BiasingProcessInterface* callingProcess) override;
+    G4VBiasingOperation* ProposeFinalStateBiasingOperation(
+        const G4Track*, const G4BiasingProcessInterface*) override { return nullptr; }
+    G4VBiasingOperation* ProposeNonPhysicsBiasingOperation(
+        const G4Track*, const G4BiasingProcessInterface*) override { return nullptr; }
+
+    using G4VBiasingOperator::OperationApplied;
+    void OperationApplied(const G4BiasingProcessInterface* callingProcess,
+                          G4BiasingAppliedCase biasingCase,
+                          G4VBiasingOperation* occurenceOperationApplied,
+                          G4double weightForOccurenceInteraction,
+                          G4VBiasingOperation* finalStateOperationApplied,
+                          const G4VParticleChange* particleChangeProduced) override;
+
+    const DetectorConstruction* fDetector;
+    G4double fFactor = 1.;
+
+    // Una operación por proceso de captura envuelto (creadas en el primer run)
+    std::map<const G4BiasingProcessInterface*, G4BOptnChangeCrossSection*> fOperations;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef ColumnarFormat_h
+#define ColumnarFormat_h 1
+
+#include <cstddef>
+#include <cstdint>
+
+// =============================================================
+// Formato columnar de los ntuples (/output/format columnar, .scol).
+// Compartido por el escritor (Geant4) y el lector (sin Geant4).
+//
+//   cabecera   "SCOL0001", uint32 nNtuples, uint32 0, esquema
+//   esquema    por ntuple: uint32 largo + nombre, uint8 activo,
+//              uint32 nColumnas; por columna: uint32 largo + nombre,
+//              uint8 tipo ('I' int32, 'D' double)
+//   bloques    ChunkHeader + nRows valores del tipo de la columna
+//   índice     nChunks × ChunkIndex
+//   cola       Trailer (posición del índice y "SCOLEND1")
+//
+// Cabecera, bloques e índice empiezan alineados a 8 bytes, así que los
+// datos de un bloque se leen directamente desde un mmap. Los bloques
+// de un mismo ntuple se escriben juntos (todas sus columnas con el
+// mismo nRows): el bloque k de una columna corresponde al bloque k de
+// las demás. Orden de bytes nativo (little endian en x86/ARM).
+// =============================================================
+namespace ColumnarFormat {
+
+constexpr char kMagic[8]    = { 'S', 'C', 'O', 'L', '0', '0', '0', '1' };
+constexpr char kEndMagic[8] = { 'S', 'C', 'O', 'L', 'E', 'N', 'D', '1' };
+constexpr std::size_t kAlignment = 8;
+
+struct ChunkHeader
+{
+    std::uint32_t ntuple;
+    std::uint32_t column;
+    std::uint64_t nRows;
+};
+
+struct ChunkIndex
+{
+    std::uint32_t ntuple;
+    std::uint32_t column;
+    std::uint64_t nRows;
+    std::uint64_t offset;   // inicio de los datos (tras el ChunkHeader)
+};
+
+struct Trailer
+{
+    std::uint64_t nChunks;
+    std::uint64_t indexOffset;
+    char magic[8];
+};
+
+inline std::size_t TypeSize(char type)
+{
+    return type == 'I' ? sizeof(std::int32_t) : sizeof(double);
+}
+
+inline std::uint64_t Padding(std::uint64_t offset)
+{
+    return (kAlignment - offset % kAlignment) % kAlignment;
+}
+
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef ColumnarReader_h
+#define ColumnarReader_h 1
+
+#include "ColumnarFormat.hh"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// =============================================================
+// Lector de archivos .scol (ver ColumnarFormat.hh), sin Geant4.
+//
+// El archivo se proyecta en memoria y las columnas se devuelven como
+// listas de bloques que apuntan directamente al mmap: recorrer
+// SiPMData.time_ns no copia ni deserializa nada.
+//
+//     ColumnarFile file("output.scol");
+//     auto time = file.GetColumn<double>("SiPMData", "time_ns");
+//     for (const auto& chunk : time.chunks)
+//         for (std::uint64_t i = 0; i < chunk.size; ++i) use(chunk.data[i]);
+//
+// Los errores (archivo ausente o incompleto, columna inexistente,
+// tipo distinto) lanzan std::runtime_error.
+// =============================================================
+struct ColumnarColumnInfo
+{
+    std::string name;
+    char type;   // 'I' int32, 'D' double
+};
+
+struct ColumnarNtupleInfo
+{
+    std::string name;
+    bool active;
+    std::vector<ColumnarColumnInfo> columns;
+};
+
+// Un bloque tal como está en el archivo
+struct ColumnarChunk
+{
+    std::uint32_t ntuple;
+    std::uint32_t column;
+    std::uint64_t nRows;
+    const void* data;
+};
+
+template <typename T>
+struct ColumnarColumn
+{
+    struct Chunk
+    {
+        const T* data;
+        std::uint64_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    std::uint64_t size = 0;   // filas totales
+};
+
+class ColumnarFile
+{
+public:
+    explicit ColumnarFile(const std::string& path);
+    ~ColumnarFile();
+
+    ColumnarFile(const ColumnarFile&) = delete;
+    ColumnarFile& operator=(const ColumnarFile&) = delete;
+
+    const std::vector<ColumnarNtupleInfo>& GetNtuples() const { return fNtuples; }
+    const std::vector<ColumnarChunk>& GetChunks() const { return fChunks; }
+
+    // T = std::int32_t para columnas 'I', double para 'D'
+    template <typename T>
+    ColumnarColumn<T> GetColumn(const std::string& ntuple, const std::string& column) const;
+
+private:
+    // Índices de ntuple y columna, verificando el tipo
+    void Find(const std::string& ntuple, const std::string& column, char type,
+              std::uint32_t& ntupleIndex, std::uint32_t& columnIndex) const;
+
+    const char* fData = nullptr;
+    std::size_t fSize = 0;
+
+    std::vector<ColumnarNtupleInfo> fNtuples;
+    std::vector<ColumnarChunk> fChunks;
+};
+
+template <typename T>
+ColumnarColumn<T> ColumnarFile::GetColumn(const std::string& ntuple, const std::string& column) const
+{
+    static_assert(sizeof(T) == sizeof(std::int32_t) || sizeof(T) == sizeof(double),
+                  "columnas int32 o double");
+    const char type = (sizeof(T) == sizeof(std::int32_t)) ? 'I' : 'D';
+
+    std::uint32_t ntupleIndex = 0;
+    std::uint32_t columnIndex = 0;
+    Find(ntuple, column, type, ntupleIndex, columnIndex);
+
+    ColumnarColumn<T> result;
+    for (const auto& chunk : fChunks) {
+        if (chunk.ntuple != ntupleIndex || chunk.column != columnIndex) continue;
+        result.chunks.push_back({ static_cast<const T*>(chunk.data), chunk.nRows });
+        result.size += chunk.nRows;
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef ColumnarWriter_h
+#define ColumnarWriter_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+
+#include "ColumnarFormat.hh"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Bloque de filas de un ntuple, una columna por vector
+struct ColumnarChunkData
+{
+    std::uint32_t ntuple = 0;
+    std::uint64_t nRows = 0;
+    std::vector<std::vector<std::int32_t>> ints;   // solo columnas 'I'
+    std::vector<std::vector<G4double>> doubles;    // solo columnas 'D'
+
+    std::size_t Bytes() const;
+};
+
+// =============================================================
+// Escritura de los ntuples en formato columnar (.scol, ver
+// ColumnarFormat.hh), alternativa al backend ROOT con
+// /output/format columnar.
+//
+// Un solo archivo para todos los hilos: el maestro lo abre al inicio
+// del run y lo cierra (índice y cola) al final. Cada hilo acumula las
+// filas en su ColumnarBuffer y entrega bloques completos a una cola;
+// un hilo de escritura propio los vuelca a disco mientras la
+// simulación continúa, sin compresión ni conversión.
+//
+// La cola tiene un tope de memoria (/output/writerMemory): si el disco
+// no da abasto, los hilos de simulación esperan en Submit() en lugar
+// de acumular filas. Los bloques escritos se reciclan con su
+// capacidad, así que la memoria no crece con el tamaño del run.
+// =============================================================
+class ColumnarWriter
+{
+public:
+    static ColumnarWriter* Instance();
+
+    // Maestro; active[i] indica si el ntuple i tendrá filas
+    G4bool Open(const G4String& fileName, const std::vector<G4bool>& active);
+    void Close();
+    G4bool IsOpen() const { return fFile != nullptr; }
+
+    // Cualquier hilo: bloque vacío (reciclado si hay) y entrega a la cola
+    std::unique_ptr<ColumnarChunkData> Acquire(std::uint32_t ntuple);
+    void Submit(std::unique_ptr<ColumnarChunkData> chunk);
+
+    struct ColumnData
+    {
+        std::uint32_t column;
+        const void* data;
+        std::uint64_t nRows;
+    };
+
+    // Escritura directa, sin cola (fusión de archivos)
+    void WriteChunk(std::uint32_t ntuple, const std::vector<ColumnData>& columns);
+
+private:
+    ColumnarWriter() = default;
+    ~ColumnarWriter() = default;
+
+    void WriterLoop();
+    void WriteChunkData(const ColumnarChunkData& chunk);
+    void WriteBytes(const void* data, std::size_t size);
+    void Pad();
+
+    // Archivo e índice (fFileMutex)
+    std::FILE* fFile = nullptr;
+    std::uint64_t fOffset = 0;
+    std::vector<ColumnarFormat::ChunkIndex> fIndex;
+    G4Mutex fFileMutex = G4MUTEX_INITIALIZER;
+
+    // Cola del hilo de escritura (fQueueMutex)
+    std::deque<std::unique_ptr<ColumnarChunkData>> fQueue;
+    std::vector<std::unique_ptr<ColumnarChunkData>> fFree;
+    std::size_t fQueuedBytes = 0;
+    std::size_t fMemoryCap = 0;
+    G4bool fStop = false;
+    G4Mutex fQueueMutex = G4MUTEX_INITIALIZER;
+    std::condition_variable fQueueReady;   // hay bloques o hay que parar
+    std::condition_variable fQueueSpace;   // la cola bajó del tope
+    std::thread fThread;
+};
+
+// =============================================================
+// Filas pendientes de un hilo, con la misma interfaz de llenado que
+// G4AnalysisManager (valores de la fila en curso + AddNtupleRow)
+// =============================================================
+class ColumnarBuffer
+{
+public:
+    static ColumnarBuffer* Local();
+
+    // Inicio del run: columnas según NtupleSchemas, sin filas
+    void Reset();
+
+    void FillNtupleIColumn(G4int id, G4int column, G4int value) { fNtuples[id].intRow[column] = value; }
+    void FillNtupleDColumn(G4int id, G4int column, G4double value) { fNtuples[id].doubleRow[column] = value; }
+    void AddNtupleRow(G4int id);
+
+    // Fin del run: entrega lo que quede
+    void Flush();
+
+private:
+    static constexpr std::size_t kChunkRows = 65536;
+
+    struct Ntuple
+    {
+        std::vector<char> types;
+        std::vector<std::int32_t> intRow;     // fila en curso (por columna)
+        std::vector<G4double> doubleRow;
+        std::unique_ptr<ColumnarChunkData> chunk;   // filas pendientes
+    };
+
+    void Flush(G4int id);
+
+    std::vector<Ntuple> fNtuples;
+};
+
+#endif
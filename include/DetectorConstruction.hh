@@ -3,10 +3,16 @@
 #define DETECTORCONSTRUCTION_HH
 
 #include "G4VUserDetectorConstruction.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
 
+#include <map>
+
 class G4VPhysicalVolume;
+class G4VTouchable;
 class G4Material;
+class G4MaterialPropertiesTable;
+class G4GenericMessenger;
 
 enum class ScintType {
     PLASTIC,
@@ -24,17 +30,75 @@ public:
     G4VPhysicalVolume* Construct() override;
     void ConstructSDandField() override;
 
-    // Setter (sin macro, lo usas desde main.cc)
-    void SetScintType(ScintType t) { fScintType = t; }
+    // Tipo de centellador: también fija sus dimensiones por defecto.
+    // Desde main.cc antes de inicializar o con /det/scintType entre runs.
+    void SetScintType(ScintType t);
+    ScintType GetScintType() const { return fScintType; }
+
+    // Captura sesgada del neutrón primario en el grafeno (--bias).
+    // Requiere G4GenericBiasingPhysics para neutrones en la lista de física.
+    void SetBiasedCapture(G4bool value) { fBiasedCapture = value; }
+
+    // Comandos /det/... : tras la inicialización reconstruyen la geometría
+    // (la física ya construida se conserva)
+    void SetScintTypeByName(const G4String& name);
+    void SetScintSize(const G4String& values);
+    void SetSiPMSize(const G4String& values);
+    void SetGrapheneThickness(G4double value);
+    void SetKaptonThickness(G4double value);
+    void SetArray(const G4String& values);
+    void SetArrayGap(G4double value);
+    void SetCaptureBiasFactor(G4double value) { fCaptureBiasFactor = value; }
+    G4double GetCaptureBiasFactor() const { return fCaptureBiasFactor; }
+
+    // Matriz de NX x NY centelladores con su SiPM (/det/array). Con 1x1
+    // se construye la geometría de una sola pieza de siempre.
+    G4int GetNumberOfChannels() const { return fArrayNx * fArrayNy; }
+
+    // Semitamaño de la zona de SiPMs (la cara de un SiPM, o toda la
+    // matriz), centrada en x = y = 0: rango del mapa de impactos
+    G4ThreeVector GetSiPMPlaneHalfSize() const;
+
+    // Canal (ix*NY + iy) del centellador o SiPM de un touchable; 0 fuera
+    // de la matriz. Lo usan los SDs en cada step.
+    static G4int GetChannel(const G4VTouchable* touchable);
 
 private:
+    void DefineMaterials();
+    G4Material* GetScintillatorMaterial();
     G4Material* CreateScintillatorMaterial();
     void DefineOpticalProperties(G4Material* scintMat);
+    void GeometryChanged();
 
     ScintType fScintType;
+    G4bool fBiasedCapture = false;
+    G4double fCaptureBiasFactor = 1000.;   // /det/biasFactor (solo con --bias)
+
+    // Dimensiones (modificables con /det/...)
+    G4ThreeVector fScintSize;
+    G4ThreeVector fSiPMSize;
+    G4double fGraphThickness;
+    G4double fKapThickness;
+
+    // Matriz de canales: réplicas de una celda centellador + SiPM
+    G4int fArrayNx = 1;
+    G4int fArrayNy = 1;
+    G4double fArrayGap = 0.;
+
+    // Materiales y tablas ópticas: se crean una sola vez por proceso y
+    // se reutilizan en cada reconstrucción de la geometría
+    G4bool fMaterialsDefined = false;
+    G4Material* fWorldMat = nullptr;
+    G4Material* fGrapheneMat = nullptr;
+    G4Material* fKaptonMat = nullptr;
+    G4Material* fSiPMMat = nullptr;
+    std::map<ScintType, G4Material*> fScintMaterials;
+    G4MaterialPropertiesTable* fSurfaceMPT = nullptr;
 
     // Para guardar punteros a volúmenes físicos si quieres más adelante
     G4VPhysicalVolume* fPhysWorld = nullptr;
+
+    G4GenericMessenger* fMessenger = nullptr;
 };
 
 #endif
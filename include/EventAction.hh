@@ -0,0 +1,121 @@
+#ifndef EventAction_h
+#define EventAction_h 1
+
+#include "G4UserEventAction.hh"
+#include "globals.hh"
+
+#include "NtupleOutput.hh"
+#include "SiPMDigitizer.hh"
+#include "SiPMWaveform.hh"
+
+#include <unordered_map>
+#include <vector>
+
+class G4Event;
+
+// =============================================================
+// Escritura de todos los ntuples al final del evento, en bloque,
+// a partir de las colecciones de hits de ScintSD y OpticalSiPM_SD.
+// Los SDs no llaman al G4AnalysisManager durante el stepping.
+// Las filas van a ROOT o al formato columnar según /output/format;
+// con /output/histograms se llenan además los H1/H2 de HistoId a
+// partir de las mismas colecciones.
+//
+// También digitaliza el SiPM (/sipm/digi/enable) sobre la colección
+// "SiPMHits" y sintetiza su forma de onda (/sipm/wave/enable), a partir
+// de las avalanchas del digitizador o, sin él, de los fotones.
+//
+// Con la matriz (/det/array) suma Edep, fotones y carga por canal en
+// el ntuple ChannelSum, una fila por canal con señal.
+// =============================================================
+class EventAction : public G4UserEventAction
+{
+public:
+    EventAction() = default;
+    ~EventAction() override = default;
+
+    void BeginOfEventAction(const G4Event*) override;
+    void EndOfEventAction(const G4Event*) override;
+
+    // Peso del track 1 tras cada step (SteppingAction)
+    void SetPrimaryWeight(G4double weight) { fPrimaryWeight = weight; }
+
+#ifdef SCINT_SUBEVENT
+    // Llegadas al SiPM de un sub-evento de fotones (--subevent), que
+    // pasan al evento padre en su EndOfEventAction
+    void MergeSubEvent(G4Event* masterEvent, const G4Event* subEvent) override;
+#endif
+
+private:
+#ifdef SCINT_SUBEVENT
+    void AttachSubEventHits(const G4Event* event);
+    void DiscardStaleSubEventHits(const G4Event* event);
+#endif
+    void WriteScintillator(const G4Event* event);
+    void WriteSiPM(const G4Event* event);
+    void WriteWaveform(G4int eventID, G4double weight);
+    void WriteChannels(const G4Event* event);
+    SiPMDigi DigitizeChannels();
+
+    // Sumas de un canal de la matriz en el evento
+    struct ChannelSum
+    {
+        G4int channel = 0;
+        G4double edep = 0.;
+        G4int nPhotons = 0;
+        G4double charge = 0.;
+    };
+    ChannelSum& GetChannelSum(G4int channel);
+
+    // IDs de las colecciones, resueltos en el primer evento
+    G4int fScintHCID = -1;
+    G4int fScintTrackHCID = -1;
+    G4int fOpticalGenHCID = -1;
+    G4int fSiPMHCID = -1;
+    G4int fScintChannelHCID = -1;
+
+    // Peso de las filas por evento: peso final del primer primario, el
+    // cociente de probabilidades de toda la historia con --bias (una
+    // sola historia por evento; 1 sin biasing)
+    G4double fPrimaryWeight = 1.;
+
+    // ROOT o columnar (/output/format)
+    NtupleOutput fOutput;
+
+    // Nivel de salida fijado al inicio de cada evento (/output/level)
+    G4bool fWriteTracks  = true;
+    G4bool fWriteSteps   = true;
+    G4bool fWritePhotons = true;
+    G4bool fFillHistograms = false;   // /output/histograms
+
+    // Digitización de microceldas (/sipm/digi/enable)
+    G4bool fDigitize = false;
+    G4int fDigitizerRunID = -1;  // run para el que está configurado el digitizador
+    SiPMDigitizer fDigitizer;
+
+    // Forma de onda y procesado tipo digitalizador (/sipm/wave/enable)
+    G4bool fWaveform = false;
+    G4bool fStoreSamples = false;
+    G4int fWaveformRunID = -1;
+    SiPMWaveform fWave;
+    std::vector<G4double> fUnitAmplitude;   // 1 p.e. por fotón sin digitizador
+
+    // Fotones detectados en el evento; buffers planos reutilizados
+    std::vector<G4double> fHitTime;
+    std::vector<G4double> fHitX;
+    std::vector<G4double> fHitY;
+    std::vector<G4int> fHitChannel;
+
+    // Matriz: canales del detector y sumas de los canales con señal
+    G4bool fArray = false;
+    std::vector<ChannelSum> fChannelSums;
+    std::unordered_map<G4int, std::size_t> fChannelIndex;
+
+    // Digitización por canal: fotones ordenados por canal
+    std::vector<std::size_t> fOrder;
+    std::vector<G4double> fChannelTime;
+    std::vector<G4double> fChannelX;
+    std::vector<G4double> fChannelY;
+};
+
+#endif
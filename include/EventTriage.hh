@@ -0,0 +1,108 @@
+#ifndef EventTriage_h
+#define EventTriage_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+
+class G4GenericMessenger;
+class G4Step;
+
+// Clasificación del evento por el triaje (columna Triage de SiPMSummary)
+enum class TriageFate : G4int {
+    TRACKED = 0,          // evento completo
+    OPTICS_SKIPPED = 1,   // Edep < minOpticsEdep: fotones no seguidos
+    ABORTED = 2           // neutrón primario fuera sin captura ni secundarios
+};
+
+// =============================================================
+// Estado y contadores de un hilo
+// =============================================================
+struct TriageTable
+{
+    G4bool active = false;
+
+    // Parámetros copiados de EventTriage al inicio del run
+    G4bool abortOnEscape = false;
+    G4double minOpticsEdep = 0.;      // 0: los fotones no se difieren
+
+    // Caja que contiene todos los volúmenes del detector (hijos del mundo)
+    G4ThreeVector regionMin;
+    G4ThreeVector regionMax;
+
+    G4int channelHCID = -1;           // "ScintSD/ScintChannelHits"
+
+    // Evento en curso
+    TriageFate fate = TriageFate::TRACKED;
+    G4bool released = false;          // fotones diferidos ya decididos
+
+    // Contadores del run
+    G4long events = 0;
+    G4long aborted = 0;
+    G4long opticsSkipped = 0;
+    G4long photonsSkipped = 0;
+
+    void Configure();
+    void BeginEvent();
+
+    // Neutrón primario: lo termina al salir de la región del detector
+    void Apply(const G4Step* step);
+
+    // Fotones ópticos en espera hasta conocer el Edep del evento
+    G4bool DefersOptics() const { return minOpticsEdep > 0. && !released; }
+
+    // Llamado al vaciarse la pila urgente; false si los nDeferred
+    // fotones en espera no deben seguirse
+    G4bool ReleaseOptics(G4int nDeferred);
+};
+
+// =============================================================
+// Triaje de eventos (/triage/). Con haz de neutrones térmicos casi
+// todos los eventos son un neutrón que cruza el aire sin capturarse:
+//  - abortOnEscape: el neutrón primario que sale de la región del
+//    detector alejándose de ella se termina. Si no quedan otros tracks
+//    (ni captura, ni dispersiones con secundarios) el evento acaba ahí.
+//  - minOpticsEdep: los fotones ópticos esperan (fWaiting) a que
+//    termine el resto del evento; si el Edep total en ScintSD queda por
+//    debajo del umbral se descartan sin seguirlos.
+// Los eventos triados se escriben igual (Edep, 0 fotones) con su
+// Triage en SiPMSummary: las eficiencias se calculan sobre todos los
+// eventos del run. El maestro imprime los contadores al final del run.
+// =============================================================
+class EventTriage
+{
+public:
+    static EventTriage* Instance();
+
+    // Estado y contadores del hilo actual
+    static TriageTable* Local();
+
+    // Llamados desde RunAction en cada hilo
+    static void BeginOfRun(G4bool isMaster);
+    static void EndOfRun(G4bool isMaster);
+
+    G4bool AbortOnEscape() const { return fAbortOnEscape; }
+    G4double GetMinOpticsEdep() const { return fMinOpticsEdep; }
+
+    // Totales del último run (todos los hilos)
+    G4long GetTotalEvents() const { return fTotals.events; }
+    G4long GetTotalAborted() const { return fTotals.aborted; }
+    G4long GetTotalOpticsSkipped() const { return fTotals.opticsSkipped; }
+
+private:
+    EventTriage();
+    ~EventTriage() = default;
+
+    void Merge(const TriageTable& table);
+    void Report() const;
+
+    G4bool fAbortOnEscape = false;
+    G4double fMinOpticsEdep = 0.;
+
+    TriageTable fTotals;
+    G4Mutex fMergeMutex = G4MUTEX_INITIALIZER;
+
+    G4GenericMessenger* fMessenger = nullptr;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef LightCollectionMap_h
+#define LightCollectionMap_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+
+#include <vector>
+
+// =============================================================
+// Mapa vóxelizado de eficiencia de colección de luz y tiempo de
+// tránsito, sobre el volumen "Scintillator".
+//
+// Calibración: cada hilo cuenta en su mapa local los fotones nacidos
+// por vóxel (ScintSD) y los que llegan al SiPM antes del PDE, con su
+// tiempo de tránsito (OpticalSiPM_SD). Al final del run los mapas
+// locales se fusionan en el compartido y el maestro lo guarda en disco.
+//
+// Modo rápido: el maestro carga el mapa compartido al inicio del run
+// y OpticalFastModel lo muestrea (solo lectura desde los workers).
+// =============================================================
+class LightCollectionMap
+{
+public:
+    LightCollectionMap() = default;
+
+    static LightCollectionMap* Shared();   // mapa fusionado / cargado
+    static LightCollectionMap* Local();    // acumulador de calibración del hilo
+
+    // Ciclo de vida dentro de RunAction
+    static void BeginOfRun(G4bool isMaster);
+    static void EndOfRun(G4bool isMaster);
+
+    // Malla sobre el volumen "Scintillator" tal como está construido
+    G4bool ConfigureFromGeometry(G4int nx, G4int ny, G4int nz,
+                                 G4int nTimeBins, G4double maxTime);
+
+    G4int VoxelIndex(const G4ThreeVector& pos) const;
+    G4ThreeVector ProjectToExitFace(const G4ThreeVector& pos) const;
+
+    // Calibración
+    void AddBorn(const G4ThreeVector& vertex);
+    void AddArrival(const G4ThreeVector& vertex, G4double transitTime);
+    void Merge(const LightCollectionMap& other);
+
+    // Modo rápido
+    G4bool IsReady() const { return fReady; }
+    G4double GetEfficiency(G4int voxel) const { return fEfficiency[voxel]; }
+    G4double SampleTransitTime(G4int voxel) const;
+
+    G4String GetFileName(const G4String& directory) const;
+    G4bool Save(const G4String& fileName) const;
+    G4bool Load(const G4String& fileName);
+
+private:
+    void Finalize();
+
+    // Vóxeles con menos nacimientos usan el promedio de todo el volumen
+    static constexpr G4double kMinBornPerVoxel = 100.;
+
+    G4String fKey;                    // material + dimensiones + malla
+    G4ThreeVector fCenter;
+    G4ThreeVector fHalfSize;
+    G4int fNx = 0, fNy = 0, fNz = 0;
+    G4int fNt = 0;
+    G4double fMaxTime = 0.;
+
+    std::vector<G4double> fBorn;      // [vóxel]
+    std::vector<G4double> fArrived;   // [vóxel]
+    std::vector<G4double> fTime;      // [vóxel * fNt + bin]
+
+    std::vector<G4double> fEfficiency;  // [vóxel]
+    std::vector<G4double> fTimeCDF;     // [vóxel * fNt + bin]
+    G4bool fReady = false;
+
+    G4Mutex fMergeMutex;
+};
+
+#endif
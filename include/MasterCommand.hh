@@ -0,0 +1,18 @@
+#ifndef MasterCommand_h
+#define MasterCommand_h 1
+
+#include "G4GenericMessenger.hh"
+#include "G4ApplicationState.hh"
+
+// =============================================================
+// Comandos de configuración (/det/, /sipm/, /output/, ...): solo en
+// el maestro, antes de inicializar o entre runs. Los workers leen
+// el valor del objeto compartido.
+// =============================================================
+inline void MasterOnly(G4GenericMessenger::Command& cmd)
+{
+    cmd.SetStates(G4State_PreInit, G4State_Idle);
+    cmd.SetToBeBroadcasted(false);
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef NtupleOutput_h
+#define NtupleOutput_h 1
+
+#include "G4AnalysisManager.hh"
+
+#include "ColumnarWriter.hh"
+#include "OutputConfig.hh"
+
+// =============================================================
+// Destino de las filas de EventAction: G4AnalysisManager (ROOT) o el
+// búfer columnar del hilo, según /output/format. Misma interfaz de
+// llenado que G4AnalysisManager; el formato se fija con Configure()
+// al inicio de cada evento.
+// =============================================================
+class NtupleOutput
+{
+public:
+    void Configure()
+    {
+        fColumnar = OutputConfig::Instance()->GetFormat() == OutputFormat::COLUMNAR;
+        fAnalysis = G4AnalysisManager::Instance();
+        fBuffer = fColumnar ? ColumnarBuffer::Local() : nullptr;
+    }
+
+    void FillNtupleIColumn(G4int id, G4int column, G4int value)
+    {
+        if (fColumnar) fBuffer->FillNtupleIColumn(id, column, value);
+        else           fAnalysis->FillNtupleIColumn(id, column, value);
+    }
+
+    void FillNtupleDColumn(G4int id, G4int column, G4double value)
+    {
+        if (fColumnar) fBuffer->FillNtupleDColumn(id, column, value);
+        else           fAnalysis->FillNtupleDColumn(id, column, value);
+    }
+
+    void AddNtupleRow(G4int id)
+    {
+        if (fColumnar) fBuffer->AddNtupleRow(id);
+        else           fAnalysis->AddNtupleRow(id);
+    }
+
+private:
+    G4bool fColumnar = false;
+    G4AnalysisManager* fAnalysis = nullptr;
+    ColumnarBuffer* fBuffer = nullptr;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef OpticalFastModel_h
+#define OpticalFastModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+
+class OpticalSiPM_SD;
+
+// =============================================================
+// Modelo rápido para fotones ópticos dentro del centellador:
+// en lugar de seguirlos hasta el SiPM, decide si llegan con la
+// eficiencia del vóxel donde nacieron y muestrea su tiempo de
+// tránsito del mapa calibrado (LightCollectionMap).
+// Activo solo con /optics/lightmap/mode fast y un mapa cargado.
+// =============================================================
+class OpticalFastModel : public G4VFastSimulationModel
+{
+public:
+    OpticalFastModel(const G4String& name, G4Region* envelope, OpticalSiPM_SD* sipmSD);
+    ~OpticalFastModel() override = default;
+
+    G4bool IsApplicable(const G4ParticleDefinition& particle) override;
+    G4bool ModelTrigger(const G4FastTrack& fastTrack) override;
+    void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override;
+
+private:
+    OpticalSiPM_SD* fSiPM;   // SD del mismo hilo
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef OpticalGenHit_h
+#define OpticalGenHit_h 1
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "G4ThreeVector.hh"
+
+// =============================================================
+// OpticalGenHit: un fotón óptico generado en el centellador
+// =============================================================
+class OpticalGenHit : public G4VHit
+{
+public:
+    OpticalGenHit() = default;
+    OpticalGenHit(G4int parentTrackID, G4int photonTrackID, G4int processID, G4int parentPDG,
+                  G4double energy, G4double time, const G4ThreeVector& pos, G4double weight)
+    : fParentTrackID(parentTrackID), fPhotonTrackID(photonTrackID),
+      fProcessID(processID), fParentPDG(parentPDG),
+      fEnergy(energy), fTime(time), fPos(pos), fWeight(weight) {}
+    ~OpticalGenHit() override = default;
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    G4int GetParentTrackID() const { return fParentTrackID; }
+    G4int GetPhotonTrackID() const { return fPhotonTrackID; }
+    G4int GetProcessID() const { return fProcessID; }
+    G4int GetParentPDG() const { return fParentPDG; }
+    G4double GetEnergy() const { return fEnergy; }
+    G4double GetTime() const { return fTime; }
+    const G4ThreeVector& GetPosition() const { return fPos; }
+    G4double GetWeight() const { return fWeight; }
+
+private:
+    G4int fParentTrackID = 0;
+    G4int fPhotonTrackID = 0;
+    G4int fProcessID = 0;      // código de ProcessDictionary
+    G4int fParentPDG = 0;
+    G4double fEnergy = 0.;
+    G4double fTime = 0.;
+    G4ThreeVector fPos;
+    G4double fWeight = 1.;     // peso estadístico del fotón (biasing)
+};
+
+using OpticalGenHitsCollection = G4THitsCollection<OpticalGenHit>;
+
+extern G4ThreadLocal G4Allocator<OpticalGenHit>* OpticalGenHitAllocator;
+
+inline void* OpticalGenHit::operator new(size_t)
+{
+    if (!OpticalGenHitAllocator) OpticalGenHitAllocator = new G4Allocator<OpticalGenHit>;
+    return (void*)OpticalGenHitAllocator->MallocSingle();
+}
+
+inline void OpticalGenHit::operator delete(void* hit)
+{
+    OpticalGenHitAllocator->FreeSingle((OpticalGenHit*)hit);
+}
+
+#endif
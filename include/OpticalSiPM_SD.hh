@@ -1,7 +1,14 @@
 #pragma once
 
 #include <G4VSensitiveDetector.hh>
+#include <G4ThreeVector.hh>
 
+#include "SiPMHit.hh"
+
+// =============================================================
+// OpticalSiPM_SD: un SiPMHit por fotón detectado (tras el PDE) en la
+// colección "SiPMHits". EventAction la escribe y la digitaliza.
+// =============================================================
 class OpticalSiPM_SD : public G4VSensitiveDetector
 {
 public:
@@ -10,9 +17,18 @@ public:
 
     virtual G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
     virtual void Initialize(G4HCofThisEvent*) override;
-    virtual void EndOfEvent(G4HCofThisEvent*) override;
+
+    // Fotón que llega al SiPM según el modelo rápido (antes del PDE)
+    void AddFastPhoton(G4double time, const G4ThreeVector& position, G4double weight);
 
 private:
-    G4int fPhotonCount;        // número total de fotones detectados en este evento
-    G4double fPDE = 0.30;      // Photo Detection Efficiency (30%)
+    void RecordPhoton(G4double time, G4double energy, const G4ThreeVector& position,
+                      G4double weight, G4int channel = 0);
+
+    SiPMHitsCollection* fHits = nullptr;
+    G4int fHCID = -1;
+
+    G4double fPDE = 0.30;      // Photo Detection Efficiency (/sipm/pde, por evento)
+    G4bool fPDEAtBirth = false;  // ya aplicado en StackingAction (/sipm/cullAtBirth)
+    G4bool fCalibrating = false; // acumulando el mapa de colección de luz
 };
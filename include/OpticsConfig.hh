@@ -0,0 +1,78 @@
+#ifndef OpticsConfig_h
+#define OpticsConfig_h 1
+
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+// Modo del mapa de colección de luz
+enum class LightMapMode {
+    OFF,         // tracking óptico completo
+    CALIBRATE,   // tracking completo + acumulación del mapa
+    FAST         // fotones reemplazados por muestreo del mapa
+};
+
+// =============================================================
+// Configuración del transporte óptico, común a todos los hilos.
+// Se fija desde macro (/optics/...) en el maestro entre runs.
+// =============================================================
+class OpticsConfig
+{
+public:
+    static OpticsConfig* Instance();
+
+    LightMapMode GetLightMapMode() const { return fLightMapMode; }
+    void SetLightMapMode(const G4String& name);
+
+    G4int GetVoxelsX() const { return fVoxelsX; }
+    G4int GetVoxelsY() const { return fVoxelsY; }
+    G4int GetVoxelsZ() const { return fVoxelsZ; }
+    void SetVoxels(const G4String& values);
+
+    G4int GetTimeBins() const { return fTimeBins; }
+    G4double GetMaxTime() const { return fMaxTime; }
+    const G4String& GetMapDirectory() const { return fMapDirectory; }
+
+    // Política de vida de los fotones ópticos (/optics/photon/); 0 o
+    // false desactivan cada criterio
+    G4bool KillOnExit() const { return fKillOnExit; }
+    G4double GetPhotonMaxTime() const { return fPhotonMaxTime; }
+    G4int GetMaxBounces() const { return fMaxBounces; }
+    G4double GetMinDetectionProbability() const { return fMinDetectionProbability; }
+    G4bool PhotonPolicyActive() const
+    {
+        return fKillOnExit || fPhotonMaxTime > 0. || fMaxBounces > 0 || fMinDetectionProbability > 0.;
+    }
+
+    // Fotones de centelleo por sub-evento (--subevent N; 0 = en el evento)
+    G4int GetSubEventSize() const { return fSubEventSize; }
+    void SetSubEventSize(G4int value) { fSubEventSize = value; }
+
+    // main.cc indica si G4FastSimulationPhysics está registrada (--fastsim)
+    G4bool HasFastSimPhysics() const { return fFastSimPhysics; }
+    void SetFastSimPhysics(G4bool value) { fFastSimPhysics = value; }
+
+private:
+    OpticsConfig();
+    ~OpticsConfig() = default;
+
+    LightMapMode fLightMapMode = LightMapMode::OFF;
+    G4int fVoxelsX = 7;
+    G4int fVoxelsY = 7;
+    G4int fVoxelsZ = 16;
+    G4int fTimeBins = 200;
+    G4double fMaxTime;
+    G4String fMapDirectory = ".";
+    G4bool fFastSimPhysics = false;
+    G4int fSubEventSize = 0;
+
+    G4bool fKillOnExit = false;
+    G4double fPhotonMaxTime = 0.;
+    G4int fMaxBounces = 0;
+    G4double fMinDetectionProbability = 0.;
+
+    G4GenericMessenger* fLightMapMessenger = nullptr;
+    G4GenericMessenger* fPhotonMessenger = nullptr;
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef OutputConfig_h
+#define OutputConfig_h 1
+
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+// Nivel de detalle de la salida. Cada nivel incluye a los anteriores.
+enum class OutputLevel {
+    SUMMARY = 0,   // ScintEvent + SiPMSummary
+    TRACK,         // + ScintTrack (Edep por track)
+    STEP,          // + ScintData (Edep por step)
+    PHOTON         // + SiPMData y OpticalGen (una fila por fotón)
+};
+
+// Formato de los ntuples
+enum class OutputFormat {
+    ROOT = 0,      // G4AnalysisManager, <salida>.root
+    COLUMNAR       // ColumnarWriter, <salida>.scol (columnas proyectables en memoria)
+};
+
+// =============================================================
+// Configuración de la salida, común a todos los hilos.
+// Se fija desde macro (/output/...) en el maestro antes de /run/beamOn
+// y los workers solo la leen durante el run.
+// =============================================================
+class OutputConfig
+{
+public:
+    static OutputConfig* Instance();
+
+    OutputLevel GetLevel() const { return fLevel; }
+    G4bool Writes(OutputLevel level) const { return fLevel >= level; }
+
+    void SetLevel(const G4String& name);
+
+    // Modo histograma: H1/H2 de HistoId llenados en EventAction
+    G4bool FillsHistograms() const { return fHistograms; }
+
+    OutputFormat GetFormat() const { return fFormat; }
+    void SetFormat(const G4String& name);
+
+    // Tope de la cola del escritor columnar (MB)
+    G4int GetWriterMemory() const { return fWriterMemory; }
+
+    // Extensión del archivo de ntuples según el formato
+    G4String GetExtension() const { return fFormat == OutputFormat::COLUMNAR ? ".scol" : ".root"; }
+
+    // Nombre base de los archivos de salida (sin extensión)
+    const G4String& GetFileName() const { return fFileName; }
+    void SetFileName(const G4String& name) { fFileName = name; }
+
+    // Sufijo de proceso o bloque (--workers: "_w<i>", --checkpoint: "_b<k>")
+    // y nombre efectivo
+    void SetFileSuffix(const G4String& suffix) { fFileSuffix = suffix; }
+    const G4String& GetFileSuffix() const { return fFileSuffix; }
+    G4String GetOutputName() const { return fFileName + fFileSuffix; }
+
+    // Otro archivo del proceso o bloque: el sufijo va antes de la
+    // extensión (profile.csv -> profile_w0.csv)
+    G4String AddFileSuffix(const G4String& fileName) const;
+
+private:
+    OutputConfig();
+    ~OutputConfig() = default;
+
+    OutputLevel fLevel = OutputLevel::PHOTON;   // por defecto se escribe todo
+    OutputFormat fFormat = OutputFormat::ROOT;
+    G4bool fHistograms = false;
+    G4int fWriterMemory = 256;
+    G4String fFileName = "output";
+    G4String fFileSuffix;
+
+    G4GenericMessenger* fMessenger = nullptr;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef OutputMerge_h
+#define OutputMerge_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+// =============================================================
+// Fusión de salidas parciales (procesos de --workers o bloques de
+// --checkpoint) en una sola: para cada ntuple de NtupleSchemas se
+// copian las filas de cada entrada en el orden dado; los histogramas
+// (/output/histograms) se suman. Entradas y
+// salida son nombres base (<base>.root o <base>.scol según
+// /output/format, y <base>_dict.csv).
+//
+// Los ntuples que ninguna entrada escribió no aparecen en la salida.
+// La fusión se escribe en <salida>.tmp, se sincroniza y sustituye a la
+// salida con rename(): una interrupción deja la salida anterior o la
+// nueva, nunca una a medias. Sin ninguna entrada falla sin tocar la
+// salida. Las entradas se conservan; RemoveOutputs las borra cuando el
+// llamador ya no las necesita.
+// =============================================================
+G4bool MergeOutputs(const std::vector<G4String>& inputs, const G4String& output);
+
+// Borra las salidas parciales (las que no existan se ignoran)
+void RemoveOutputs(const std::vector<G4String>& inputs);
+
+// fsync de un archivo ya cerrado (o de un directorio)
+G4bool SyncPath(const G4String& path);
+
+// fsync del directorio de path, tras crearlo o renombrarlo
+G4bool SyncDirectoryOf(const G4String& path);
+
+#endif
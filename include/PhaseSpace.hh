@@ -0,0 +1,96 @@
+#ifndef PhaseSpace_h
+#define PhaseSpace_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+class G4Event;
+class G4GenericMessenger;
+class G4Track;
+
+// Una partícula en la entrada del centellador (40 bytes en disco)
+struct PhaseSpaceRecord
+{
+    std::int32_t pdg;
+    float ekin;          // MeV
+    float x, y, z;       // mm
+    float dx, dy, dz;
+    float time;          // ns
+    float weight;
+};
+
+// =============================================================
+// Simulación en dos etapas a través de un archivo de espacio de
+// fases binario en la entrada del volumen "Scintillator".
+//
+// Grabación (/phasespace/record archivo): ScintSD guarda cada
+// partícula cargada o gamma que entra al centellador; al final del
+// evento el bloque se añade al archivo (un solo archivo para todos
+// los hilos). Los eventos sin partículas no ocupan espacio, pero se
+// cuentan en la cabecera para normalizar.
+//
+// Reproducción (/phasespace/replay archivo): el maestro proyecta el
+// archivo en memoria (mmap) al inicio del run y PrimaryGeneratorAction
+// genera el evento i a partir del bloque i (módulo el número de
+// bloques), sin transporte de neutrones.
+//
+// Formato: cabecera { "PSPACE01", uint32 tamaño de registro, uint32 0,
+// uint64 eventos fuente, uint64 bloques } y bloques { uint32 evento,
+// uint32 n, n × PhaseSpaceRecord }.
+// =============================================================
+class PhaseSpace
+{
+public:
+    static PhaseSpace* Instance();
+
+    // Ciclo de vida dentro de RunAction y EventAction
+    static void BeginOfRun(G4bool isMaster);
+    static void EndOfRun(G4bool isMaster);
+    void BeginOfEvent();
+    void EndOfEvent(G4int eventID);
+
+    // Grabación (desde ScintSD); RecordRequested: /phasespace/record activo
+    G4bool IsRecording() const { return fRecordFile != nullptr; }
+    G4bool RecordRequested() const { return fRecordName != "none"; }
+    void Record(const G4Track* track, const G4ThreeVector& position,
+                const G4ThreeVector& direction, G4double ekin, G4double time);
+
+    // Reproducción (desde PrimaryGeneratorAction)
+    G4bool IsReplaying() const { return fData != nullptr; }
+    void GeneratePrimaries(G4Event* event) const;
+
+private:
+    PhaseSpace();
+    ~PhaseSpace() = default;
+
+    G4bool OpenRecord();
+    void CloseRecord();
+    G4bool OpenReplay();
+    void CloseReplay();
+
+    // Nombres fijados desde macro ("none": desactivado)
+    G4String fRecordName = "none";
+    G4String fReplayName = "none";
+
+    // Grabación: archivo compartido, escrito bajo mutex
+    G4String fRecordPath;                 // fRecordName con el sufijo del proceso
+    std::FILE* fRecordFile = nullptr;
+    std::uint64_t fSourceEvents = 0;
+    std::uint64_t fBlocks = 0;
+    G4Mutex fWriteMutex = G4MUTEX_INITIALIZER;
+
+    // Reproducción: archivo proyectado en memoria (solo lectura) y
+    // posición de cada bloque
+    const char* fData = nullptr;
+    std::size_t fSize = 0;
+    std::vector<std::size_t> fBlockOffsets;
+
+    G4GenericMessenger* fMessenger = nullptr;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef PhotonPolicy_h
+#define PhotonPolicy_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+
+#include <array>
+#include <vector>
+
+class G4LogicalVolume;
+class G4OpBoundaryProcess;
+class G4Step;
+class LightCollectionMap;
+
+// Destino final de un fotón óptico seguido
+enum class PhotonFate : G4int {
+    SIPM,          // llega al SiPM (antes del PDE)
+    ABSORBED,      // OpAbsorption (u otra absorción en volumen)
+    WORLD,         // sale del volumen mundo
+    EXIT,          // política: refractado al aire (killOnExit)
+    TIME,          // política: tiempo global > maxTime
+    BOUNCES,       // política: reflexiones > maxBounces
+    PROBABILITY,   // política: probabilidad restante < minDetectionProbability
+    OTHER,         // otros procesos (WLS, modelo rápido, ...)
+    COUNT
+};
+
+// =============================================================
+// Estado y contadores de un hilo. El contador de reflexiones se
+// reinicia en el primer step de cada fotón: no hace falta ninguna
+// información por track.
+// =============================================================
+struct PhotonLossTable
+{
+    G4bool active = false;
+
+    // Parámetros copiados de OpticsConfig al inicio del run
+    G4bool killOnExit = false;
+    G4double maxTime = 0.;
+    G4int maxBounces = 0;
+    G4double minProbability = 0.;
+    G4double pde = 1.;                     // 1 con /sipm/cullAtBirth
+    const LightCollectionMap* map = nullptr;
+
+    // Volúmenes de aire en los que un fotón ya no vuelve (mundo y
+    // envolventes de la matriz)
+    std::vector<const G4LogicalVolume*> escapeVolumes;
+    const G4LogicalVolume* sipmVolume = nullptr;
+
+    G4OpBoundaryProcess* boundary = nullptr;   // proceso de este hilo
+    G4int bounces = 0;                         // del fotón en curso
+
+    std::array<G4long, static_cast<std::size_t>(PhotonFate::COUNT)> counts{};
+
+    void Configure();
+    void Apply(const G4Step* step);
+
+private:
+    void Kill(const G4Step* step, PhotonFate fate);
+    PhotonFate NaturalFate(const G4Step* step) const;
+};
+
+// =============================================================
+// Política de vida de los fotones ópticos (/optics/photon/): deja de
+// seguir los fotones que salen al aire, llegan fuera de la ventana,
+// quedan atrapados por reflexión total o ya casi no pueden detectarse.
+// Cada fotón terminado se cuenta por destino y el maestro imprime la
+// tabla de pérdidas al final del run. Inactiva (sin coste más allá de
+// una comprobación por step) si ningún criterio está fijado.
+// =============================================================
+class PhotonPolicy
+{
+public:
+    static PhotonPolicy* Instance();
+
+    // Estado y contadores del hilo actual
+    static PhotonLossTable* Local();
+
+    // Llamados desde RunAction en cada hilo
+    static void BeginOfRun(G4bool isMaster);
+    static void EndOfRun(G4bool isMaster);
+
+    // Total del último run por destino (todos los hilos)
+    G4long GetTotal(PhotonFate fate) const { return fTotals[static_cast<std::size_t>(fate)]; }
+
+private:
+    PhotonPolicy() = default;
+    ~PhotonPolicy() = default;
+
+    void Merge(const PhotonLossTable& table);
+    void Report() const;
+
+    std::array<G4long, static_cast<std::size_t>(PhotonFate::COUNT)> fTotals{};
+    G4Mutex fMergeMutex;
+};
+
+#endif
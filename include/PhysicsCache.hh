@@ -0,0 +1,43 @@
+#ifndef PhysicsCache_h
+#define PhysicsCache_h 1
+
+#include "globals.hh"
+
+class G4VUserPhysicsList;
+
+// =============================================================
+// Caché de tablas de física entre ejecuciones (--cache dir).
+//
+// Tras Initialize se calcula una suma de verificación sobre la
+// versión de Geant4, la lista de física, los materiales (composición,
+// densidad, Birks y tablas de propiedades ópticas) y los cortes de
+// cada región. Cada combinación usa su propio subdirectorio
+// dir/<checksum>/: si ya existe se recuperan las tablas, si no se
+// construyen y se guardan. Un cambio en cualquiera de esos datos da
+// otro checksum, así que una caché obsoleta nunca se usa.
+//
+// Solo se guardan las tablas que Geant4 sabe persistir (EM, ópticas);
+// los datos HP de neutrones se leen siempre de G4NDL.
+// =============================================================
+class PhysicsCache
+{
+public:
+    PhysicsCache(const G4String& directory, const G4String& physicsTag);
+
+    // Llamar tras Initialize y antes del primer run
+    void Prepare(G4VUserPhysicsList* physicsList);
+
+    // Llamar tras el primer run (BeamOn(0) construye las tablas)
+    void Finish(G4VUserPhysicsList* physicsList);
+
+private:
+    G4String Describe() const;
+
+    G4String fRoot;
+    G4String fPhysicsTag;
+    G4String fDescription;
+    G4String fDirectory;
+    G4bool fRetrieving = false;
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef PhysicsList_h
+#define PhysicsList_h 1
+
+#include "globals.hh"
+
+class G4VModularPhysicsList;
+
+// =============================================================
+// Lista de física del proyecto: QGSP_BIC_HP sin desintegración
+// radiactiva + física óptica (+ simulación rápida con --fastsim,
+// + biasing genérico de neutrones con --bias).
+// Compartida por Scintillator_Sipm y Scintillator_Sipm_bench.
+// =============================================================
+G4VModularPhysicsList* CreatePhysicsList(G4bool fastSim, G4bool bias);
+
+// Descripción de las opciones de la lista de física (clave de la caché)
+G4String PhysicsListTag(G4bool fastSim, G4bool bias);
+
+#endif
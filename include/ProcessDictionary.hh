@@ -0,0 +1,46 @@
+#ifndef ProcessDictionary_h
+#define ProcessDictionary_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+
+#include <unordered_map>
+#include <vector>
+
+class G4VProcess;
+
+// =============================================================
+// Tabla de códigos enteros para nombres de procesos, común a todos
+// los hilos. El código 0 se reserva para "primary" (sin proceso creador).
+//
+// El maestro registra al inicio del run todos los procesos de la
+// G4ProcessTable en orden alfabético, así los códigos no dependen del
+// orden en que los hilos ven cada proceso. Los workers resuelven
+// G4VProcess* -> código con una caché local sin bloqueo.
+// =============================================================
+class ProcessDictionary
+{
+public:
+    static ProcessDictionary* Instance();
+
+    // Maestro, al inicio del run
+    void RegisterProcessTable();
+
+    // Código del proceso (0 si es nullptr)
+    G4int GetCode(const G4VProcess* process);
+
+    // Tabla código -> nombre en CSV, junto a los ntuples
+    void Write(const G4String& fileName) const;
+
+private:
+    ProcessDictionary();
+    ~ProcessDictionary() = default;
+
+    G4int Intern(const G4String& name);
+
+    std::vector<G4String> fNames;                 // índice = código
+    std::unordered_map<std::string, G4int> fCodes;
+    mutable G4Mutex fMutex;
+};
+
+#endif
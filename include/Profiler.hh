@@ -0,0 +1,105 @@
+#ifndef Profiler_h
+#define Profiler_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+
+#include <chrono>
+#include <map>
+#include <unordered_map>
+
+class G4GenericMessenger;
+class G4ParticleDefinition;
+class G4Step;
+class G4Track;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+// Nivel de instrumentación (/profile/level)
+enum class ProfileLevel {
+    OFF,     // sin coste: los actions solo comprueban el nivel
+    COUNT,   // steps y tracks por partícula, proceso y volumen
+    TIME     // además tiempo de pared (steady_clock) por step; en MT incluye
+             // las esperas del hilo, no es tiempo de CPU
+};
+
+// =============================================================
+// Contadores de un hilo. Las claves son punteros (sin cadenas en el
+// stepping); los procesos son objetos distintos en cada hilo, así
+// que la fusión se hace por nombre al final del run.
+// =============================================================
+struct ProfileEntry
+{
+    G4long steps = 0;
+    G4double seconds = 0.;
+};
+
+struct ProfileTable
+{
+    ProfileLevel level = ProfileLevel::OFF;
+
+    std::unordered_map<const G4ParticleDefinition*, ProfileEntry> particles;
+    std::unordered_map<const G4VProcess*, ProfileEntry> processes;
+    std::unordered_map<const G4VPhysicalVolume*, ProfileEntry> volumes;
+
+    G4long steps = 0;
+    G4long tracks = 0;
+    G4long opticalPhotons = 0;   // fotones ópticos seguidos
+    G4double seconds = 0.;
+
+    std::chrono::steady_clock::time_point lastTime;
+
+    void Clear();
+    void StartTrack(const G4Track* track);
+    void RecordStep(const G4Step* step);
+};
+
+// =============================================================
+// Perfil de steps por partícula, proceso y volumen.
+// Se activa desde macro (/profile/level count|time) entre runs; al
+// final del run el maestro imprime el ranking y lo guarda en CSV.
+// Con SCINT_PROFILING=OFF en CMake los actions no lo llaman nunca.
+// =============================================================
+class Profiler
+{
+public:
+    static Profiler* Instance();
+
+    // Contadores del hilo actual
+    static ProfileTable* Local();
+
+    // Llamados desde RunAction en cada hilo
+    static void BeginOfRun(G4bool isMaster);
+    static void EndOfRun(G4bool isMaster);
+
+    ProfileLevel GetLevel() const { return fLevel; }
+    void SetLevel(const G4String& name);
+
+    // Totales del último run (todos los hilos)
+    G4long GetTotalSteps() const { return fTotalSteps; }
+    G4long GetTotalTracks() const { return fTotalTracks; }
+    G4long GetTotalOpticalPhotons() const { return fTotalOpticalPhotons; }
+
+private:
+    Profiler();
+    ~Profiler() = default;
+
+    void Merge(const ProfileTable& table);
+    void Report() const;
+
+    ProfileLevel fLevel = ProfileLevel::OFF;
+    G4String fFileName = "profile.csv";
+    G4int fTop = 15;
+
+    // Acumulado del run por nombre: categoría -> nombre -> contadores
+    std::map<G4String, std::map<G4String, ProfileEntry>> fEntries;
+    G4long fTotalSteps = 0;
+    G4long fTotalTracks = 0;
+    G4long fTotalOpticalPhotons = 0;
+    G4double fTotalSeconds = 0.;
+
+    G4Mutex fMergeMutex = G4MUTEX_INITIALIZER;
+    G4GenericMessenger* fMessenger = nullptr;
+};
+
+#endif
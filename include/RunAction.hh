@@ -3,10 +3,52 @@
 
 #include "G4UserRunAction.hh"
 #include "globals.hh"
+#include "G4ThreeVector.hh"
 #include <fstream>
+#include <vector>
 
 class G4Run;
 
+// Identificadores de los ntuples reservados en RunAction
+namespace NtupleId {
+    constexpr G4int ScintData   = 0;
+    constexpr G4int ScintEvent  = 1;
+    constexpr G4int SiPMData    = 2;
+    constexpr G4int SiPMSummary = 3;
+    constexpr G4int OpticalGen  = 4;
+    constexpr G4int ScintTrack  = 5;
+    constexpr G4int SiPMDigi    = 6;
+    constexpr G4int SiPMWave    = 7;
+    constexpr G4int SiPMWaveSamples = 8;
+    constexpr G4int ChannelSum  = 9;
+}
+
+// Histogramas (/output/histograms true); binning con /analysis/h1/set
+// y /analysis/h2/set
+namespace HistoId {
+    constexpr G4int TotalEdep  = 0;   // H1: Edep total por evento (MeV)
+    constexpr G4int NPhotons   = 1;   // H1: fotones detectados por evento
+    constexpr G4int PhotonTime = 2;   // H1: tiempo de llegada de cada fotón (ns)
+    constexpr G4int SiPMHitMap = 0;   // H2: x/y de cada fotón en el SiPM (mm)
+}
+
+// Columnas de un ntuple: 'I' entero, 'D' doble
+struct NtupleColumn
+{
+    const char* name;
+    char type;
+};
+
+struct NtupleSchema
+{
+    const char* name;
+    const char* title;
+    std::vector<NtupleColumn> columns;
+};
+
+// Todos los ntuples, indexados por NtupleId
+const std::vector<NtupleSchema>& NtupleSchemas();
+
 class RunAction : public G4UserRunAction
 {
 public:
@@ -17,6 +59,10 @@ public:
     virtual void EndOfRunAction(const G4Run*);
 
     std::ofstream outputFile; // opcional
+
+private:
+    // Semitamaño de la zona de SiPMs con el que está definido SiPMHitMap
+    G4ThreeVector fHitMapHalfSize;
 };
 
 #endif
@@ -0,0 +1,138 @@
+#ifndef ScintHit_h
+#define ScintHit_h 1
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "G4ThreeVector.hh"
+
+// =============================================================
+// ScintHit: un step con depósito de energía en el centellador
+// =============================================================
+class ScintHit : public G4VHit
+{
+public:
+    ScintHit() = default;
+    ScintHit(G4int trackID, G4int pdg, G4int creatorID,
+             G4double ekin, G4double edep, const G4ThreeVector& pos, G4double weight)
+    : fTrackID(trackID), fPDG(pdg), fCreatorID(creatorID),
+      fKineticEnergy(ekin), fEdep(edep), fPos(pos), fWeight(weight) {}
+    ~ScintHit() override = default;
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    void Draw() override;
+
+    G4int GetTrackID() const { return fTrackID; }
+    G4int GetPDG() const { return fPDG; }
+    G4int GetCreatorID() const { return fCreatorID; }
+    G4double GetKineticEnergy() const { return fKineticEnergy; }
+    G4double GetEdep() const { return fEdep; }
+    const G4ThreeVector& GetPosition() const { return fPos; }
+    G4double GetWeight() const { return fWeight; }
+
+private:
+    G4int fTrackID = 0;
+    G4int fPDG = 0;
+    G4int fCreatorID = 0;          // código de ProcessDictionary
+    G4double fKineticEnergy = 0.;  // en el pre-step
+    G4double fEdep = 0.;
+    G4ThreeVector fPos;            // pre-step
+    G4double fWeight = 1.;         // peso estadístico del track (biasing)
+};
+
+// =============================================================
+// ScintTrackHit: energía total depositada por un track en el evento
+// =============================================================
+class ScintTrackHit : public G4VHit
+{
+public:
+    ScintTrackHit() = default;
+    ScintTrackHit(G4int trackID, G4int pdg, G4double weight)
+    : fTrackID(trackID), fPDG(pdg), fWeight(weight) {}
+    ~ScintTrackHit() override = default;
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    void AddEdep(G4double edep) { fEdep += edep; }
+
+    G4int GetTrackID() const { return fTrackID; }
+    G4int GetPDG() const { return fPDG; }
+    G4double GetEdep() const { return fEdep; }
+    G4double GetWeight() const { return fWeight; }
+
+private:
+    G4int fTrackID = 0;
+    G4int fPDG = 0;
+    G4double fEdep = 0.;
+    G4double fWeight = 1.;
+};
+
+// =============================================================
+// ScintChannelHit: energía depositada en un canal de la matriz
+// (/det/array) en el evento; con una sola pieza, un único canal 0
+// =============================================================
+class ScintChannelHit : public G4VHit
+{
+public:
+    ScintChannelHit() = default;
+    explicit ScintChannelHit(G4int channel) : fChannel(channel) {}
+    ~ScintChannelHit() override = default;
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    void AddEdep(G4double edep) { fEdep += edep; }
+
+    G4int GetChannel() const { return fChannel; }
+    G4double GetEdep() const { return fEdep; }
+
+private:
+    G4int fChannel = 0;
+    G4double fEdep = 0.;
+};
+
+using ScintHitsCollection        = G4THitsCollection<ScintHit>;
+using ScintTrackHitsCollection   = G4THitsCollection<ScintTrackHit>;
+using ScintChannelHitsCollection = G4THitsCollection<ScintChannelHit>;
+
+extern G4ThreadLocal G4Allocator<ScintHit>* ScintHitAllocator;
+extern G4ThreadLocal G4Allocator<ScintTrackHit>* ScintTrackHitAllocator;
+extern G4ThreadLocal G4Allocator<ScintChannelHit>* ScintChannelHitAllocator;
+
+inline void* ScintHit::operator new(size_t)
+{
+    if (!ScintHitAllocator) ScintHitAllocator = new G4Allocator<ScintHit>;
+    return (void*)ScintHitAllocator->MallocSingle();
+}
+
+inline void ScintHit::operator delete(void* hit)
+{
+    ScintHitAllocator->FreeSingle((ScintHit*)hit);
+}
+
+inline void* ScintTrackHit::operator new(size_t)
+{
+    if (!ScintTrackHitAllocator) ScintTrackHitAllocator = new G4Allocator<ScintTrackHit>;
+    return (void*)ScintTrackHitAllocator->MallocSingle();
+}
+
+inline void ScintTrackHit::operator delete(void* hit)
+{
+    ScintTrackHitAllocator->FreeSingle((ScintTrackHit*)hit);
+}
+
+inline void* ScintChannelHit::operator new(size_t)
+{
+    if (!ScintChannelHitAllocator) ScintChannelHitAllocator = new G4Allocator<ScintChannelHit>;
+    return (void*)ScintChannelHitAllocator->MallocSingle();
+}
+
+inline void ScintChannelHit::operator delete(void* hit)
+{
+    ScintChannelHitAllocator->FreeSingle((ScintChannelHit*)hit);
+}
+
+#endif
@@ -3,11 +3,25 @@
 
 #include "G4VSensitiveDetector.hh"
 #include "globals.hh"
-#include <map>
+
+#include "ScintHit.hh"
+#include "OpticalGenHit.hh"
+
+#include <unordered_map>
 
 class G4Step;
+class G4HCofThisEvent;
 class G4TouchableHistory;
 
+// =============================================================
+// ScintSD: registra en colecciones de hits del evento
+//   "ScintHits"      un hit por step con Edep (nivel step)
+//   "ScintTrackHits" Edep acumulada por track (siempre)
+//   "ScintChannelHits" Edep acumulada por canal de la matriz (siempre)
+//   "OpticalGenHits" fotones ópticos generados (nivel photon)
+// y las partículas que entran al centellador (/phasespace/record).
+// La escritura al ntuple la hace EventAction al final del evento.
+// =============================================================
 class ScintSD : public G4VSensitiveDetector
 {
 public:
@@ -16,11 +30,29 @@ public:
 
     virtual void Initialize(G4HCofThisEvent*);
     virtual G4bool ProcessHits(G4Step*, G4TouchableHistory*);
-    virtual void EndOfEvent(G4HCofThisEvent*);
 
 private:
-    // Acumulador de energía por TrackID en este evento
-    std::map<G4int, G4double> fEdepPerTrack;
+    ScintHitsCollection* fStepHits = nullptr;
+    ScintTrackHitsCollection* fTrackHits = nullptr;
+    OpticalGenHitsCollection* fOpticalGenHits = nullptr;
+    ScintChannelHitsCollection* fChannelHits = nullptr;
+
+    G4int fStepHCID = -1;
+    G4int fTrackHCID = -1;
+    G4int fOpticalGenHCID = -1;
+    G4int fChannelHCID = -1;
+
+    // TrackID -> índice en fTrackHits para este evento
+    std::unordered_map<G4int, std::size_t> fTrackIndex;
+
+    // Canal -> índice en fChannelHits para este evento
+    std::unordered_map<G4int, std::size_t> fChannelIndex;
+
+    // Nivel de salida fijado al inicio de cada evento (/output/level)
+    G4bool fWriteSteps   = true;
+    G4bool fWritePhotons = true;
+    G4bool fCalibrating  = false;   // /optics/lightmap/mode calibrate
+    G4bool fRecordPhaseSpace = false; // /phasespace/record
 };
 
 #endif
@@ -0,0 +1,94 @@
+#ifndef SiPMConfig_h
+#define SiPMConfig_h 1
+
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+// =============================================================
+// Parámetros del SiPM, comunes a todos los hilos.
+// Se fijan desde macro (/sipm/...) en el maestro entre runs.
+// =============================================================
+class SiPMConfig
+{
+public:
+    static SiPMConfig* Instance();
+
+    G4double GetPDE() const { return fPDE; }
+
+    // PDE aplicado al nacer el fotón (StackingAction) en lugar de al llegar.
+    // No se aplica mientras se calibra el mapa de luz, que necesita
+    // todas las llegadas.
+    G4bool CullAtBirth() const;
+
+    // Digitización de microceldas (/sipm/digi/...)
+    G4bool DigitizationEnabled() const { return fDigitize; }
+    G4double GetCellPitch() const { return fCellPitch; }
+    G4double GetRecoveryTime() const { return fRecoveryTime; }
+    G4double GetCrosstalkProbability() const { return fCrosstalk; }
+    G4double GetAfterpulseProbability() const { return fAfterpulse; }
+    G4double GetAfterpulseTime() const { return fAfterpulseTime; }
+    G4double GetDarkRate() const { return fDarkRate; }
+    G4double GetGateStart() const { return fGateStart; }
+    G4double GetGateWidth() const { return fGateWidth; }
+
+    // Forma de onda del digitalizador (/sipm/wave/...)
+    G4bool WaveformEnabled() const { return fWaveform; }
+    G4bool StoreWaveformSamples() const { return fWaveStoreSamples; }
+    G4double GetSamplingRate() const { return fSamplingRate; }
+    G4double GetRecordLength() const { return fRecordLength; }
+    G4double GetPreTrigger() const { return fPreTrigger; }
+    G4double GetPulseRiseTime() const { return fPulseRise; }
+    G4double GetPulseDecayTime() const { return fPulseDecay; }
+    G4double GetADCGain() const { return fADCGain; }
+    G4double GetADCNoise() const { return fADCNoise; }
+    G4int GetADCBits() const { return fADCBits; }
+    G4double GetADCBaseline() const { return fADCBaseline; }
+    G4double GetTriggerThreshold() const { return fTriggerThreshold; }
+    G4double GetCFDFraction() const { return fCFDFraction; }
+    G4double GetCFDDelay() const { return fCFDDelay; }
+    G4double GetChargePreGate() const { return fChargePreGate; }
+    G4double GetChargeGate() const { return fChargeGate; }
+    G4double GetPileUpFraction() const { return fPileUpFraction; }
+
+private:
+    SiPMConfig();
+    ~SiPMConfig() = default;
+
+    G4double fPDE = 0.30;          // Photo Detection Efficiency (30%)
+    G4bool fCullAtBirth = false;
+
+    G4bool fDigitize = false;
+    G4double fCellPitch;           // paso de microcelda
+    G4double fRecoveryTime;        // constante de recuperación de la celda
+    G4double fCrosstalk = 0.10;    // probabilidad de crosstalk por avalancha
+    G4double fAfterpulse = 0.05;   // probabilidad de afterpulse por avalancha
+    G4double fAfterpulseTime;      // retardo medio del afterpulse
+    G4double fDarkRate;            // DCR de todo el dispositivo
+    G4double fGateStart;
+    G4double fGateWidth;
+
+    G4bool fWaveform = false;
+    G4bool fWaveStoreSamples = false;
+    G4double fSamplingRate;        // muestras por unidad de tiempo
+    G4double fRecordLength;        // ventana de adquisición
+    G4double fPreTrigger;          // muestras antes del primer pulso
+    G4double fPulseRise;           // forma del pulso de 1 p.e.
+    G4double fPulseDecay;
+    G4double fADCGain = 20.;       // cuentas ADC por p.e. (amplitud de pico)
+    G4double fADCNoise = 2.;       // ruido electrónico (cuentas RMS)
+    G4int fADCBits = 14;
+    G4double fADCBaseline = 1000.; // cuentas
+    G4double fTriggerThreshold = 0.5;   // p.e.
+    G4double fCFDFraction = 0.3;
+    G4double fCFDDelay;
+    G4double fChargePreGate;
+    G4double fChargeGate;
+    G4double fPileUpFraction = 0.2;     // segundo flanco respecto a la amplitud
+
+    G4GenericMessenger* fMessenger = nullptr;
+    G4GenericMessenger* fDigiMessenger = nullptr;
+    G4GenericMessenger* fWaveMessenger = nullptr;
+};
+
+#endif
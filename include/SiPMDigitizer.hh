@@ -0,0 +1,124 @@
+#ifndef SiPMDigitizer_h
+#define SiPMDigitizer_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+// Resultado de la digitización de un evento
+struct SiPMDigi
+{
+    G4int nFiredCells = 0;     // microceldas distintas que dispararon en la ventana
+    G4double charge = 0.;      // carga total en p.e. (con recuperación de celdas)
+    G4int nPhotons = 0;        // avalanchas iniciadas por fotones en la ventana
+    G4int nDark = 0;           // cuentas oscuras térmicas
+    G4int nCrosstalk = 0;      // avalanchas por crosstalk óptico
+    G4int nAfterpulse = 0;     // afterpulses
+
+    // Suma de canales de la matriz
+    SiPMDigi& operator+=(const SiPMDigi& other)
+    {
+        nFiredCells += other.nFiredCells;
+        charge      += other.charge;
+        nPhotons    += other.nPhotons;
+        nDark       += other.nDark;
+        nCrosstalk  += other.nCrosstalk;
+        nAfterpulse += other.nAfterpulse;
+        return *this;
+    }
+};
+
+// =============================================================
+// Digitización a nivel de microcelda del SiPM, al final del evento.
+//
+// Los fotones detectados se asignan a una malla de microceldas sobre
+// la cara del SiPM. Las avalanchas (fotones, cuentas oscuras,
+// crosstalk y afterpulses) se procesan en orden temporal dentro de la
+// ventana: una celda que vuelve a disparar aporta 1-exp(-dt/tau_rec).
+//
+// Con la matriz (/det/array) cada canal se digitaliza por separado
+// sobre la misma malla de un SiPM: las posiciones se llevan al centro
+// de su celda y el contador invalida la malla entre canales, así que
+// la memoria no crece con el número de canales.
+//
+// Una instancia por hilo. Todos los buffers son planos y se reutilizan
+// entre eventos; el estado de las celdas se invalida con un contador
+// de evento, sin recorrer la malla.
+// =============================================================
+class SiPMDigitizer
+{
+public:
+    SiPMDigitizer() = default;
+
+    // Malla sobre el volumen "SiPM" y parámetros de /sipm/digi/
+    G4bool Configure();
+
+    // Vacía las avalanchas acumuladas; una vez por evento
+    void BeginEvent();
+
+    // Tiempos y posiciones (globales) de los fotones detectados en un
+    // canal; sus avalanchas se añaden a las del evento
+    SiPMDigi Digitize(const std::vector<G4double>& time,
+                      const std::vector<G4double>& x,
+                      const std::vector<G4double>& y,
+                      G4int channel = 0);
+
+    // Avalanchas del evento, de todos los canales (tiempo y amplitud en
+    // p.e.), para la forma de onda (/sipm/wave/)
+    const std::vector<G4double>& GetPulseTimes() const { return fPulseTime; }
+    const std::vector<G4double>& GetPulseAmplitudes() const { return fPulseAmplitude; }
+
+private:
+    enum class Origin : G4int { PHOTON, DARK, CROSSTALK, AFTERPULSE };
+
+    struct Avalanche
+    {
+        G4double time;
+        G4int cell;
+        Origin origin;
+
+        // std::push_heap construye un max-heap: invertimos para el más temprano
+        G4bool operator<(const Avalanche& other) const { return time > other.time; }
+    };
+
+    void Push(G4double time, G4int cell, Origin origin);
+    G4int RandomNeighbour(G4int cell) const;
+
+    // Malla
+    G4int fCellsX = 0;
+    G4int fCellsY = 0;
+    G4double fPitch = 0.;
+    G4double fX0 = 0.;   // esquina -X,-Y de la cara activa
+    G4double fY0 = 0.;
+
+    // Matriz: origen (esquina -X,-Y), paso y celdas en Y; fArrayNy = 0
+    // con una sola pieza
+    G4int fArrayNy = 0;
+    G4double fArrayX0 = 0.;
+    G4double fArrayY0 = 0.;
+    G4double fArrayPitchX = 0.;
+    G4double fArrayPitchY = 0.;
+
+    // Parámetros copiados de SiPMConfig al configurar
+    G4double fRecovery = 0.;
+    G4double fCrosstalk = 0.;
+    G4double fAfterpulse = 0.;
+    G4double fAfterpulseTau = 0.;
+    G4double fDarkRate = 0.;
+    G4double fGateStart = 0.;
+    G4double fGateEnd = 0.;
+
+    // Estado por celda, válido solo si fStamp == fEpoch
+    std::vector<G4double> fLastFire;
+    std::vector<G4int> fStamp;
+    G4int fEpoch = 0;
+
+    // Cola de avalanchas del evento (min-heap por tiempo)
+    std::vector<Avalanche> fQueue;
+
+    // Avalanchas procesadas, en orden temporal dentro de cada canal
+    std::vector<G4double> fPulseTime;
+    std::vector<G4double> fPulseAmplitude;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SiPMHit_h
+#define SiPMHit_h 1
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "G4ThreeVector.hh"
+
+// =============================================================
+// SiPMHit: un fotón óptico detectado en el SiPM (tras el PDE)
+// =============================================================
+class SiPMHit : public G4VHit
+{
+public:
+    SiPMHit() = default;
+    SiPMHit(G4double time, G4double energy, const G4ThreeVector& pos, G4double weight,
+            G4int channel = 0)
+    : fTime(time), fEnergy(energy), fPos(pos), fWeight(weight), fChannel(channel) {}
+    ~SiPMHit() override = default;
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    void Draw() override;
+
+    G4double GetTime() const { return fTime; }
+    G4double GetEnergy() const { return fEnergy; }
+    const G4ThreeVector& GetPosition() const { return fPos; }
+    G4double GetWeight() const { return fWeight; }
+    G4int GetChannel() const { return fChannel; }
+
+private:
+    G4double fTime = 0.;       // tiempo global de llegada
+    G4double fEnergy = 0.;     // 0 si viene del modelo rápido
+    G4ThreeVector fPos;
+    G4double fWeight = 1.;     // peso estadístico del fotón (biasing)
+    G4int fChannel = 0;        // canal de la matriz (/det/array)
+};
+
+using SiPMHitsCollection = G4THitsCollection<SiPMHit>;
+
+extern G4ThreadLocal G4Allocator<SiPMHit>* SiPMHitAllocator;
+
+inline void* SiPMHit::operator new(size_t)
+{
+    if (!SiPMHitAllocator) SiPMHitAllocator = new G4Allocator<SiPMHit>;
+    return (void*)SiPMHitAllocator->MallocSingle();
+}
+
+inline void SiPMHit::operator delete(void* hit)
+{
+    SiPMHitAllocator->FreeSingle((SiPMHit*)hit);
+}
+
+#endif
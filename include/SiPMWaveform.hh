@@ -0,0 +1,90 @@
+#ifndef SiPMWaveform_h
+#define SiPMWaveform_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+// Parámetros extraídos de la forma de onda de un evento
+struct SiPMWaveFeatures
+{
+    G4double baseline = 0.;    // cuentas ADC (media del pre-disparo)
+    G4double amplitude = 0.;   // cuentas ADC sobre la línea base
+    G4double cfdTime = -1.;    // tiempo global del CFD (-1 sin disparo)
+    G4double charge = 0.;      // carga en la puerta, en p.e.
+    G4bool pileUp = false;     // segundo flanco dentro de la puerta
+    G4bool saturated = false;  // alguna muestra en el límite del ADC
+};
+
+// =============================================================
+// Forma de onda muestreada del SiPM y procesado tipo digitalizador
+// (CAEN), al final del evento.
+//
+// Síntesis: cada pulso (fotón detectado, o avalancha si la
+// digitización de microceldas está activa) se reparte linealmente
+// entre las dos muestras vecinas y el tren resultante se convoluciona
+// con el pulso de 1 p.e. muestreado (exp(-t/tau_caída) -
+// exp(-t/tau_subida), pico = ganancia). La convolución es un axpy
+// sobre arrays contiguos de float que el compilador vectoriza, y solo
+// se hace para las muestras con carga. Después se añaden ruido
+// gaussiano y la cuantización del ADC.
+//
+// La ventana empieza /sipm/wave/preTrigger antes del primer pulso
+// (auto-disparo), así que una puerta larga de CsI (~1 us) cuesta
+// O(muestras × longitud del pulso), independiente de los fotones.
+//
+// Procesado: línea base (pre-disparo), disparo por umbral, amplitud,
+// tiempo CFD digital interpolado, carga integrada en la puerta y
+// marca de pile-up. Una instancia por hilo; buffers reutilizados.
+// =============================================================
+class SiPMWaveform
+{
+public:
+    SiPMWaveform() = default;
+
+    // Parámetros de /sipm/wave/ y pulso de 1 p.e. muestreado
+    void Configure();
+
+    // Tiempos globales y amplitudes (p.e.) de los pulsos del evento
+    SiPMWaveFeatures Process(const std::vector<G4double>& time,
+                             const std::vector<G4double>& amplitude);
+
+    // Muestras ADC del último evento e instante de la primera
+    const std::vector<std::int32_t>& GetSamples() const { return fADC; }
+    G4double GetStartTime() const { return fStartTime; }
+    G4double GetSamplePeriod() const { return fPeriod; }
+
+private:
+    void Synthesize(const std::vector<G4double>& time, const std::vector<G4double>& amplitude);
+    SiPMWaveFeatures Analyze() const;
+
+    // Muestreo y ADC
+    G4double fPeriod = 0.;
+    std::size_t fNSamples = 0;
+    std::size_t fNPreTrigger = 0;
+    G4double fGain = 0.;
+    G4double fNoise = 0.;
+    G4double fBaseline = 0.;
+    std::int32_t fADCMax = 0;
+
+    // Procesado
+    G4double fThreshold = 0.;        // cuentas ADC
+    G4double fCFDFraction = 0.;
+    std::size_t fCFDDelay = 1;       // muestras
+    std::size_t fPreGate = 0;
+    std::size_t fGate = 0;
+    G4double fPileUpFraction = 0.;
+
+    // Pulso de 1 p.e. (pico 1) y su área en muestras
+    std::vector<float> fKernel;
+    G4double fKernelArea = 1.;
+
+    // Buffers del evento
+    G4double fStartTime = 0.;
+    std::vector<float> fDeposit;       // p.e. por muestra
+    std::vector<float> fSignal;        // señal analógica (cuentas)
+    std::vector<std::int32_t> fADC;    // muestras digitalizadas
+};
+
+#endif
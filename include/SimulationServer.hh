@@ -0,0 +1,113 @@
+#ifndef SimulationServer_h
+#define SimulationServer_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
+
+// =============================================================
+// Servidor de simulación (--server socket|-, --jobs N).
+//
+// Geant4 se inicializa una vez (geometría, datos HP y tablas de
+// física) y el proceso atiende trabajos por un socket UNIX o por la
+// entrada estándar. Cada trabajo se ejecuta en un hijo creado con
+// fork(): parte del estado recién inicializado (los /det/... o /gun/...
+// de un trabajo no afectan a los siguientes) y comparte su memoria
+// copia-en-escritura. Hasta N trabajos simultáneos; el resto espera en
+// cola.
+//
+// Protocolo de texto, una línea por orden:
+//   output <base>      nombre base de la salida (por defecto job_<id>)
+//   seed <n>           semilla (por defecto la del servidor + id)
+//   /comando ...       comando de Geant4 (p.ej. /run/beamOn 10000)
+//   end                encola el trabajo
+//   status             estado de la cola
+//   shutdown           termina tras los trabajos pendientes
+// Respuestas: READY, QUEUED <id>, STARTED <id>, DONE <id> status=...
+// con eventos, tiempos y salida, y ERROR <motivo>.
+// =============================================================
+class SimulationServer
+{
+public:
+    // endpoint: ruta del socket o "-" para stdin/stdout
+    SimulationServer(const G4String& endpoint, G4int maxJobs, long baseSeed);
+    ~SimulationServer();
+
+    // true en un hijo, con su trabajo terminado; false en el servidor
+    // tras shutdown (o el fin de stdin)
+    G4bool Serve();
+
+    // Servidor: false si no se pudo abrir el socket
+    G4bool IsOk() const { return fOk; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job
+    {
+        G4int id = 0;
+        G4int connection = -1;        // índice en fConnections; -1 si se cerró
+        std::vector<G4String> commands;
+        G4String output;
+        long seed = 0;
+        G4bool hasSeed = false;
+        Clock::time_point queued;
+    };
+
+    struct Connection
+    {
+        G4int in = -1;
+        G4int out = -1;
+        G4bool open = false;
+        G4bool reading = true;        // false tras el fin de stdin
+        std::string buffer;           // líneas incompletas
+        Job pending;                  // trabajo en construcción
+        G4bool inJob = false;
+    };
+
+    struct Running
+    {
+        Job job;
+        G4int pid = -1;
+        G4int pipe = -1;              // resultado del hijo
+        std::string result;
+        Clock::time_point started;
+    };
+
+    G4bool Open();
+    void Close();
+
+    void Accept();
+    void Read(std::size_t index);
+    void HandleLine(std::size_t index, const std::string& line);
+    void Send(G4int connection, const std::string& line);
+    void CloseConnection(std::size_t index);
+
+    // Arranca trabajos de la cola; true en el hijo
+    G4bool StartJobs();
+    void RunJob(const Job& job);
+    void Finish(std::size_t index);
+
+    G4String fEndpoint;
+    G4int fMaxJobs;
+    long fBaseSeed;
+    G4bool fStdin;
+
+    G4int fListen = -1;
+    G4bool fOk = true;
+    G4bool fShutdown = false;
+    G4int fNextId = 1;
+    G4int fDone = 0;
+
+    std::vector<Connection> fConnections;
+    std::deque<Job> fQueue;
+    std::vector<Running> fRunning;
+
+    // Hijo: tubería hacia el servidor
+    G4int fResultPipe = -1;
+};
+
+#endif
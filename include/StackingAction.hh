@@ -0,0 +1,46 @@
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "globals.hh"
+
+class G4Track;
+struct TriageTable;
+
+// Tipo de sub-evento de los fotones de centelleo (--subevent)
+constexpr G4int kOpticalSubEventType = 0;
+
+// =============================================================
+// Con /sipm/cullAtBirth, aplica el PDE del SiPM a cada fotón óptico
+// en el momento de crearse: solo se siguen los que serían detectados
+// si llegan, y OpticalSiPM_SD cuenta todas las llegadas.
+//
+// Con --subevent (compilado con SCINT_SUBEVENT) los fotones de
+// centelleo van a la pila de sub-eventos: Geant4 los agrupa en lotes
+// que siguen otros hilos y EventAction::MergeSubEvent devuelve sus
+// hits al evento padre.
+//
+// Con /triage/minOpticsEdep los fotones esperan en la pila fWaiting
+// hasta que termina el resto del evento; NewStage decide entonces si
+// se siguen (EventTriage).
+// =============================================================
+class StackingAction : public G4UserStackingAction
+{
+public:
+    StackingAction();
+    ~StackingAction() override = default;
+
+    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track) override;
+    void NewStage() override;
+    void PrepareNewEvent() override;
+
+private:
+    G4bool fCull = false;     // fijado al inicio de cada evento
+    G4double fPDE = 1.;
+    G4bool fSubEvent = false;
+
+    TriageTable* fTriage;            // triaje de este hilo
+    G4bool fReclassifying = false;   // fotones ya diferidos (PDE aplicado)
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef StartupTimer_h
+#define StartupTimer_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <map>
+#include <utility>
+#include <vector>
+
+class G4ParticleDefinition;
+class G4VPhysicsConstructor;
+
+// =============================================================
+// Desglose del tiempo de arranque (--timing): fases de main medidas
+// con reloj de pared, la construcción de la geometría y las tablas de
+// física de cada partícula. Las tablas se miden con un proceso inerte
+// al final de la lista de cada partícula (sin DoIt, sin coste en el
+// stepping), así que la línea del neutrón es la carga de los datos HP.
+// Solo mide el maestro; el informe se imprime una vez, antes de la
+// macro.
+// =============================================================
+class StartupTimer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static StartupTimer* Instance();
+
+    // Cierra la fase en curso de main y abre otra
+    void Phase(const G4String& name);
+
+    // Tiempo de una parte interna de una fase (geometría)
+    void AddDetail(const G4String& name, G4double seconds);
+
+    // Llamado por los marcadores al preparar y construir las tablas
+    void MarkTables(const G4ParticleDefinition* particle, G4bool built);
+
+    // Registra los marcadores de tablas; antes de Initialize
+    static G4VPhysicsConstructor* CreateMarkerPhysics();
+
+    void Report();
+
+    // Mide el ámbito en que vive y lo añade como detalle
+    class Measure
+    {
+    public:
+        explicit Measure(const G4String& name) : fName(name), fStart(Clock::now()) {}
+        ~Measure();
+
+    private:
+        G4String fName;
+        Clock::time_point fStart;
+    };
+
+private:
+    StartupTimer();
+    ~StartupTimer() = default;
+
+    Clock::time_point fStart;
+    Clock::time_point fPhaseStart;
+    G4String fPhaseName;
+
+    std::vector<std::pair<G4String, G4double>> fPhases;
+    std::vector<std::pair<G4String, G4double>> fDetails;
+
+    // Tablas de física por partícula
+    std::map<G4String, G4double> fTables;
+    Clock::time_point fLastTableMark;
+
+    G4bool fReported = false;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef SteppingAction_h
+#define SteppingAction_h 1
+
+#include "G4UserSteppingAction.hh"
+#include "globals.hh"
+
+class EventAction;
+struct ProfileTable;
+struct PhotonLossTable;
+struct TriageTable;
+
+// =============================================================
+// Peso del primario para las filas por evento (EventAction), triaje
+// del neutrón primario (/triage/abortOnEscape), política de
+// vida de los fotones ópticos (/optics/photon/) y perfil de steps
+// (/profile/level): una comprobación por step cuando están
+// desactivados. Sin SCINT_PROFILING el perfil no se compila.
+// =============================================================
+class SteppingAction : public G4UserSteppingAction
+{
+public:
+    explicit SteppingAction(EventAction* eventAction);
+    ~SteppingAction() override = default;
+
+    void UserSteppingAction(const G4Step* step) override;
+
+private:
+    EventAction* fEventAction;
+    ProfileTable* fProfile;     // contadores de este hilo
+    PhotonLossTable* fPhotons;  // política y pérdidas de este hilo
+    TriageTable* fTriage;       // triaje de este hilo
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef TrackingAction_h
+#define TrackingAction_h 1
+
+#include "G4UserTrackingAction.hh"
+#include "globals.hh"
+
+struct ProfileTable;
+
+// =============================================================
+// Perfil de steps (/profile/level): cuenta tracks y fotones ópticos
+// y marca el inicio del reloj de cada track.
+// =============================================================
+class TrackingAction : public G4UserTrackingAction
+{
+public:
+    TrackingAction();
+    ~TrackingAction() override = default;
+
+    void PreUserTrackingAction(const G4Track* track) override;
+
+private:
+    ProfileTable* fProfile;   // contadores de este hilo
+};
+
+#endif
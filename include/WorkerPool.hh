@@ -0,0 +1,44 @@
+#ifndef WorkerPool_h
+#define WorkerPool_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+// =============================================================
+// Procesos de trabajo tras la inicialización (--workers N).
+//
+// El proceso padre inicializa Geant4 una sola vez (geometría, datos
+// HP y tablas de física) y después hace fork(): los N hijos comparten
+// esa memoria copia-en-escritura. Cada hijo ejecuta la macro con su
+// parte de los eventos (BatchRunManager) y escribe <salida>_w<i>; el
+// padre espera a todos y fusiona los ntuples en <salida> en orden de
+// proceso, que es el orden global de los eventos.
+// =============================================================
+class WorkerPool
+{
+public:
+    explicit WorkerPool(G4int nWorkers);
+
+    // true en el hijo (GetIndex() válido); false en el padre, cuando
+    // todos los hijos han terminado
+    G4bool Fork();
+
+    G4int GetIndex() const { return fIndex; }
+
+    // Hijo: comunica al padre el formato y el nombre base de su salida
+    void FinishChild();
+
+    // Padre: true si todos los hijos terminaron bien y la fusión se escribió
+    G4bool Merge();
+
+private:
+    G4int fNWorkers;
+    G4int fIndex = -1;
+    G4int fPipe = -1;              // hijo: extremo de escritura
+
+    std::vector<G4String> fChildOutputs;   // padre: "formato\nbase" de cada hijo
+    G4bool fChildrenOk = true;
+};
+
+#endif
@@ -1,31 +1,234 @@
-#include "G4RunManager.hh"
+#include "G4RunManagerFactory.hh"
 #include "G4UImanager.hh"
-#include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 #include "G4ScoringManager.hh"
+#include "G4VModularPhysicsList.hh"
 #include "Randomize.hh"
 
-// Física
-#include "QGSP_BIC_HP.hh"
-#include "G4OpticalPhysics.hh"
+// Sin SCINT_NO_VIS (Scintillator_Sipm_batch) la visualización se crea
+// solo si la sesión o la macro la usan
+#ifndef SCINT_NO_VIS
+#include "G4VisExecutive.hh"
+#endif
 
 // Usuario
 #include "ActionInitialization.hh"
 #include "DetectorConstruction.hh"
+#include "PhysicsList.hh"
+#include "PhysicsCache.hh"
+#include "BatchRunManager.hh"
+#include "OutputConfig.hh"
+#include "WorkerPool.hh"
+#include "OpticsConfig.hh"
+#include "StackingAction.hh"
+#include "StartupTimer.hh"
+#include "SimulationServer.hh"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+void PrintUsage()
+{
+    G4cerr << "Uso: Scintillator_Sipm [macro.mac] [-t nThreads] [-r Serial|MT|Tasking] [--fastsim] [--bias] [--cache dir]\n"
+           << "                      [--workers N] [--checkpoint K] [--subevent N] [--timing]\n"
+           << "                      [--server socket|- [--jobs N]]\n"
+           << "  -t, --threads      número de hilos de trabajo (activa el modo MT/tasking)\n"
+           << "  -r, --runmanager   tipo de G4RunManager (por defecto Serial, o Default si se da -t)\n"
+           << "  --fastsim          registra la simulación rápida para fotones ópticos\n"
+           << "                     (se activa con /optics/lightmap/mode fast)\n"
+           << "  --bias             sesga la captura del neutrón primario en el grafeno (/det/biasFactor)\n"
+           << "                     (resultados ponderados: columna Weight de los ntuples)\n"
+           << "  --cache dir        guarda/recupera las tablas de física en dir (por checksum)\n"
+           << "  --workers N        N procesos tras una sola inicialización (fork), salida fusionada\n"
+           << "                     en un único archivo; requiere macro y excluye -t/-r\n"
+           << "  --checkpoint K     guarda la salida y el estado cada K eventos; al relanzar\n"
+           << "                     el mismo comando se reanuda (requiere macro y excluye -t/-r)\n"
+           << "  --subevent N       los fotones de centelleo de cada evento se siguen en lotes de N\n"
+           << "                     repartidos entre los hilos (requiere -t; compilado con SCINT_SUBEVENT)\n"
+           << "  --timing           construye las tablas de física antes de la macro e imprime el\n"
+           << "                     desglose del arranque (geometría, tablas por partícula, datos HP)\n"
+           << "  --server socket    inicializa una vez y atiende trabajos por un socket UNIX (o por\n"
+           << "                     stdin con -); la macro, si se da, se ejecuta antes (excluye -t/-r)\n"
+           << "  --jobs N           trabajos simultáneos del servidor (procesos fork, por defecto 1)\n";
+}
+
+// ¿Usa la macro (o las que ejecuta) la visualización? En batch el
+// G4VisExecutive y sus drivers solo se crean si hace falta.
+G4bool MacroUsesVis(const G4String& fileName, G4int depth = 0)
+{
+    std::ifstream macro(fileName);
+    if (!macro || depth > 8) return false;
 
-int main(int argc, char** argv) 
+    std::string line;
+    while (std::getline(macro, line)) {
+        std::istringstream is(line);
+        std::string command;
+        is >> command;
+
+        if (command.rfind("/vis/", 0) == 0 || command.rfind("/score/draw", 0) == 0)
+            return true;
+
+        // Macros anidadas: /control/execute, /control/loop y /control/foreach
+        if (command == "/control/execute" || command == "/control/loop" ||
+            command == "/control/foreach") {
+            std::string nested;
+            if (is >> nested && MacroUsesVis(nested, depth + 1))
+                return true;
+        }
+    }
+    return false;
+}
+
+}
+
+int main(int argc, char** argv)
 {
-    G4Random::setTheSeed(123456789);
+    // Origen del desglose del arranque (--timing)
+    auto startup = StartupTimer::Instance();
+    startup->Phase("argumentos y run manager");
+
+    // ----------------------------------
+    // Argumentos de línea de comandos
+    // ----------------------------------
+    G4String macro;
+    G4int nThreads = 0;
+    G4String runManagerType;
+    G4bool fastSim = false;
+    G4bool bias = false;
+    G4String cacheDir;
+    G4int nWorkers = 0;
+    G4int checkpointInterval = 0;
+    G4int subEventSize = 0;
+    G4bool timing = false;
+    G4String serverEndpoint;
+    G4int serverJobs = 1;
+
+    for (G4int i = 1; i < argc; ++i) {
+        G4String arg = argv[i];
+        if ((arg == "-t" || arg == "--threads") && i + 1 < argc) {
+            nThreads = std::atoi(argv[++i]);
+        }
+        else if ((arg == "-r" || arg == "--runmanager") && i + 1 < argc) {
+            runManagerType = argv[++i];
+        }
+        else if (arg == "--fastsim") {
+            fastSim = true;
+        }
+        else if (arg == "--bias") {
+            bias = true;
+        }
+        else if (arg == "--cache" && i + 1 < argc) {
+            cacheDir = argv[++i];
+        }
+        else if (arg == "--workers" && i + 1 < argc) {
+            nWorkers = std::atoi(argv[++i]);
+        }
+        else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpointInterval = std::atoi(argv[++i]);
+        }
+        else if (arg == "--subevent" && i + 1 < argc) {
+            subEventSize = std::atoi(argv[++i]);
+        }
+        else if (arg == "--timing") {
+            timing = true;
+        }
+        else if (arg == "--server" && i + 1 < argc) {
+            serverEndpoint = argv[++i];
+        }
+        else if (arg == "--jobs" && i + 1 < argc) {
+            serverJobs = std::atoi(argv[++i]);
+        }
+        else if (arg[0] != '-' && macro.empty()) {
+            macro = arg;
+        }
+        else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // Procesos de trabajo y puntos de control: secuencial y solo en batch
+    const G4bool batchRun = nWorkers > 0 || checkpointInterval > 0;
+    if (batchRun && (macro.empty() || nThreads > 0 || !runManagerType.empty())) {
+        PrintUsage();
+        return 1;
+    }
+
+    // Sub-eventos: G4SubEvtRunManager con hilos, sin --workers/--checkpoint
+    if (subEventSize > 0) {
+#ifndef SCINT_SUBEVENT
+        G4cerr << "--subevent requiere compilar con -DSCINT_SUBEVENT=ON (Geant4 >= 11.2)\n";
+        return 1;
+#endif
+        if (batchRun || nThreads <= 0 || !runManagerType.empty()) {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // Servidor: secuencial (un fork por trabajo), sin otros modos de ejecución
+    const G4bool server = !serverEndpoint.empty();
+    if (server && (batchRun || subEventSize > 0 || nThreads > 0 || !runManagerType.empty() ||
+                   serverJobs <= 0)) {
+        PrintUsage();
+        return 1;
+    }
+
+    // Visualización: sesión interactiva o comandos /vis/ en la macro
+    const G4bool useVis = !server && (macro.empty() || MacroUsesVis(macro));
+#ifdef SCINT_NO_VIS
+    if (!macro.empty() && useVis) {
+        G4cerr << macro << " usa /vis/: Scintillator_Sipm_batch se compila sin visualización\n";
+        return 1;
+    }
+#endif
+
+    // Sin -t se conserva el comportamiento secuencial de siempre
+    if (runManagerType.empty())
+        runManagerType = (nThreads > 0) ? "Default" : "Serial";
 
     try {
         // Modo UI
         G4UIExecutive* ui = nullptr;
-        if (argc == 1) {
+        if (macro.empty() && !server) {
             ui = new G4UIExecutive(argc, argv);
         }
 
-        // Run Manager
-        auto* runManager = new G4RunManager();
+        // En MT la semilla del maestro genera las semillas de cada evento;
+        // con --workers/--checkpoint BatchRunManager la deriva por evento global
+        const long masterSeed = 123456789;
+
+        // Run Manager (secuencial, MT o tasking según la línea de comandos,
+        // o BatchRunManager con --workers/--checkpoint)
+        G4RunManager* runManager = nullptr;
+        BatchRunManager* batchRunManager = nullptr;
+        if (batchRun) {
+            batchRunManager = new BatchRunManager(masterSeed);
+            batchRunManager->SetCheckpointInterval(checkpointInterval);
+            batchRunManager->SetCheckpointKey(macro);
+            runManager = batchRunManager;
+        }
+#ifdef SCINT_SUBEVENT
+        else if (subEventSize > 0) {
+            // Los fotones de centelleo (StackingAction) forman sub-eventos
+            // de hasta subEventSize tracks
+            runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::SubEvt);
+            runManager->RegisterSubEventType(kOpticalSubEventType, subEventSize);
+            OpticsConfig::Instance()->SetSubEventSize(subEventSize);
+        }
+#endif
+        else {
+            runManager = G4RunManagerFactory::CreateRunManager(
+                G4RunManagerFactory::GetType(runManagerType));
+        }
+        if (nThreads > 0)
+            runManager->SetNumberOfThreads(nThreads);
+
+        G4Random::setTheSeed(masterSeed);
 
         // Scoring
         G4ScoringManager::GetScoringManager();
@@ -35,33 +238,104 @@ int main(int argc, char** argv)
 
         // Elegir centellador (sin macros)
         detector->SetScintType(ScintType::PLASTIC);
+        detector->SetBiasedCapture(bias);
 
         runManager->SetUserInitialization(detector);
 
-        // Física Hadron + Física Óptica
-        auto* physicsList = new QGSP_BIC_HP();
-        physicsList->SetVerboseLevel(0);
-        // ----------------------------------
-        // DESACTIVAR RADIOACTIVE DECAY
-        // ----------------------------------
-        physicsList->RemovePhysics("G4DecayPhysics");
-        physicsList->RemovePhysics("G4RadioactiveDecay");
-
-        // Física óptica (NADA MÁS)
-        auto* opticalPhysics = new G4OpticalPhysics();
-        physicsList->RegisterPhysics(opticalPhysics);
-
+        // Física Hadron + Física Óptica (+ simulación rápida con --fastsim,
+        // + biasing de neutrones con --bias)
+        startup->Phase("lista de física y partículas");
+        auto* physicsList = CreatePhysicsList(fastSim, bias);
+        if (timing)
+            physicsList->RegisterPhysics(StartupTimer::CreateMarkerPhysics());
         runManager->SetUserInitialization(physicsList);
 
         // Actions
         runManager->SetUserInitialization(new ActionInitialization());
 
-        // Inicializar G4
+        // Inicializar G4 (en MT incluye las tablas de física del maestro)
+        startup->Phase("inicialización (geometría y procesos)");
         runManager->Initialize();
 
-        // Visualización
-        auto* visManager = new G4VisExecutive();
-        visManager->Initialize();
+        // Caché de tablas de física: un run vacío las construye (o las
+        // recupera) ahora, antes de la macro
+        startup->Phase("tablas de física (run vacío)");
+        if (!cacheDir.empty()) {
+            PhysicsCache cache(cacheDir, PhysicsListTag(fastSim, bias));
+            cache.Prepare(physicsList);
+            runManager->BeamOn(0);
+            cache.Finish(physicsList);
+        }
+        // --workers y --server: los hijos heredan las tablas con fork();
+        // --timing: el coste de las tablas se mide aquí y no en el primer run
+        else if (nWorkers > 0 || server || timing) {
+            runManager->BeamOn(0);
+        }
+
+        // --workers: las tablas se construyen una vez aquí y los hijos las
+        // heredan con fork(); cada hijo ejecuta la macro con su parte de
+        // los eventos y el padre fusiona las salidas
+        if (nWorkers > 0) {
+            if (timing) startup->Report();
+
+            auto* UImanager = G4UImanager::GetUIpointer();
+            UImanager->ApplyCommand("/control/verbose 1");
+            UImanager->ApplyCommand("/run/verbose 0");
+            UImanager->ApplyCommand("/event/verbose 0");
+            UImanager->ApplyCommand("/tracking/verbose 0");
+
+            WorkerPool pool(nWorkers);
+            if (pool.Fork()) {
+                batchRunManager->SetWorker(pool.GetIndex(), nWorkers);
+                OutputConfig::Instance()->SetFileSuffix("_w" + std::to_string(pool.GetIndex()));
+
+                G4String command = "/control/execute ";
+                UImanager->ApplyCommand(command + macro);
+                batchRunManager->FinishCheckpoints();
+                pool.FinishChild();
+
+                delete runManager;
+                return 0;
+            }
+
+            const G4bool merged = pool.Merge();
+            delete runManager;
+            return merged ? 0 : 1;
+        }
+
+        // --server: la macro (configuración común) se ejecuta una vez y
+        // cada trabajo corre en un hijo a partir de ese estado
+        if (server) {
+            if (timing) startup->Report();
+
+            auto* UImanager = G4UImanager::GetUIpointer();
+            UImanager->ApplyCommand("/control/verbose 1");
+            UImanager->ApplyCommand("/run/verbose 0");
+            UImanager->ApplyCommand("/event/verbose 0");
+            UImanager->ApplyCommand("/tracking/verbose 0");
+            if (!macro.empty()) {
+                G4String command = "/control/execute ";
+                UImanager->ApplyCommand(command + macro);
+            }
+
+            SimulationServer simulationServer(serverEndpoint, serverJobs, masterSeed);
+            const G4bool child = simulationServer.Serve();
+            const G4bool ok = child || simulationServer.IsOk();
+
+            delete runManager;
+            return ok ? 0 : 1;
+        }
+
+        // Visualización: solo en sesión interactiva o si la macro la usa
+#ifndef SCINT_NO_VIS
+        startup->Phase("visualización");
+        G4VisManager* visManager = nullptr;
+        if (useVis) {
+            visManager = new G4VisExecutive();
+            visManager->Initialize();
+        }
+#endif
+        if (timing) startup->Report();
 
         // UI manager
         auto* UImanager = G4UImanager::GetUIpointer();
@@ -74,17 +348,21 @@ int main(int argc, char** argv)
         // Batch o interactivo
         if (!ui) {
             G4String command = "/control/execute ";
-            G4String macro = argv[1];
             UImanager->ApplyCommand(command + macro);
+            if (batchRunManager) batchRunManager->FinishCheckpoints();
         }
         else {
+#ifndef SCINT_NO_VIS
             UImanager->ApplyCommand("/control/execute ../macros/vis1.mac");
+#endif
             ui->SessionStart();
             delete ui;
         }
 
         // Limpieza
+#ifndef SCINT_NO_VIS
         delete visManager;
+#endif
         delete runManager;
     }
     catch (...) {
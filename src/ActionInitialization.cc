@@ -1,10 +1,28 @@
 #include "ActionInitialization.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "RunAction.hh"
+#include "EventAction.hh"
+#include "StackingAction.hh"
+#include "SteppingAction.hh"
+#include "TrackingAction.hh"
+#include "OutputConfig.hh"
+#include "OpticsConfig.hh"
+#include "SiPMConfig.hh"
+#include "Profiler.hh"
+#include "PhaseSpace.hh"
+#include "EventTriage.hh"
 
 ActionInitialization::ActionInitialization()
 : G4VUserActionInitialization()
-{}
+{
+    // Configuración compartida: se crea en el maestro para registrar sus comandos
+    OutputConfig::Instance();
+    OpticsConfig::Instance();
+    SiPMConfig::Instance();
+    Profiler::Instance();
+    PhaseSpace::Instance();
+    EventTriage::Instance();
+}
 
 ActionInitialization::~ActionInitialization()
 {}
@@ -18,4 +36,16 @@ void ActionInitialization::Build() const
 {
     SetUserAction(new PrimaryGeneratorAction());
     SetUserAction(new RunAction());
+    auto eventAction = new EventAction();
+    SetUserAction(eventAction);
+    SetUserAction(new StackingAction());
+
+    // Peso del primario, política de fotones ópticos (/optics/photon/) y,
+    // con SCINT_PROFILING, perfil de steps
+    SetUserAction(new SteppingAction(eventAction));
+
+#ifdef SCINT_PROFILING
+    // Perfil de steps (/profile/level); sin SCINT_PROFILING no hay ningún coste
+    SetUserAction(new TrackingAction());
+#endif
 }
@@ -0,0 +1,300 @@
+#include "BatchRunManager.hh"
+#include "OutputConfig.hh"
+#include "OutputMerge.hh"
+#include "PhaseSpace.hh"
+
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// SplitMix64: mezcla barata y bien distribuida para derivar semillas
+std::uint64_t SplitMix64(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// FNV-1a del contenido de un archivo; 0 si no se puede leer
+std::uint64_t HashFile(const G4String& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) return 0;
+
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    char c;
+    while (in.get(c)) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// =============================================================
+// Estado de los puntos de control
+// =============================================================
+struct CheckpointState
+{
+    std::uint64_t seed = 0;
+    std::uint64_t key = 0;    // hash de la macro (SetCheckpointKey)
+    G4int run = -1;           // índice del /run/beamOn
+    G4int first = 0;          // primer evento global del rango de este proceso
+    G4int events = 0;         // eventos del rango
+    G4int interval = 0;       // eventos por bloque
+    G4int next = 0;           // siguiente evento global por simular
+    G4int done = 0;           // 1: bloques fusionados en la salida del run
+
+    G4bool SameJob(const CheckpointState& other) const
+    {
+        return seed == other.seed && key == other.key;
+    }
+
+    G4bool SameRun(const CheckpointState& other) const
+    {
+        return SameJob(other) && run == other.run && first == other.first &&
+               events == other.events && interval == other.interval;
+    }
+};
+
+G4bool ReadState(const std::string& fileName, CheckpointState& state)
+{
+    std::ifstream in(fileName);
+    std::string key;
+    G4int found = 0;
+    while (in >> key) {
+        if      (key == "seed")     { in >> state.seed;     ++found; }
+        else if (key == "key")      { in >> state.key;      ++found; }
+        else if (key == "run")      { in >> state.run;      ++found; }
+        else if (key == "first")    { in >> state.first;    ++found; }
+        else if (key == "events")   { in >> state.events;   ++found; }
+        else if (key == "interval") { in >> state.interval; ++found; }
+        else if (key == "next")     { in >> state.next;     ++found; }
+        else if (key == "done")     { in >> state.done;     ++found; }
+    }
+    return found == 8;
+}
+
+// Escritura atómica: archivo temporal sincronizado y rename()
+G4bool WriteState(const std::string& fileName, const CheckpointState& state)
+{
+    const std::string tmp = fileName + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << "seed "     << state.seed     << "\n"
+            << "key "      << state.key      << "\n"
+            << "run "      << state.run      << "\n"
+            << "first "    << state.first    << "\n"
+            << "events "   << state.events   << "\n"
+            << "interval " << state.interval << "\n"
+            << "next "     << state.next     << "\n"
+            << "done "     << state.done     << "\n";
+        if (!out) return false;
+    }
+    if (!SyncPath(tmp) || std::rename(tmp.c_str(), fileName.c_str()) != 0)
+        return false;
+    return SyncDirectoryOf(fileName);
+}
+
+}
+
+BatchRunManager::BatchRunManager(std::uint64_t masterSeed)
+    : G4RunManager(), fMasterSeed(masterSeed)
+{}
+
+void BatchRunManager::SetCheckpointKey(const G4String& macroFile)
+{
+    fCheckpointKey = HashFile(macroFile);
+}
+
+void BatchRunManager::SetWorker(G4int index, G4int nWorkers)
+{
+    fNWorkers = std::max(1, nWorkers);
+    fWorkerIndex = std::clamp(index, 0, fNWorkers - 1);
+}
+
+// =============================================================
+// Reparto de /run/beamOn N: los primeros N % n procesos simulan un
+// evento más. Los rangos son contiguos y en orden de proceso.
+// =============================================================
+void BatchRunManager::BeamOn(G4int n_event, const char* macroFile, G4int n_select)
+{
+    if (n_event <= 0) {
+        G4RunManager::BeamOn(n_event, macroFile, n_select);
+        return;
+    }
+
+    fCurrentRun = fRunIndex++;
+
+    const G4int base = n_event / fNWorkers;
+    const G4int extra = n_event % fNWorkers;
+
+    const G4int firstEvent = fWorkerIndex * base + std::min(fWorkerIndex, extra);
+    const G4int nLocal = base + (fWorkerIndex < extra ? 1 : 0);
+
+    if (fCheckpointInterval > 0 && nLocal > 0) {
+        BeamOnWithCheckpoints(fCurrentRun, firstEvent, nLocal, macroFile, n_select);
+        return;
+    }
+
+    // Un proceso sin eventos no abre la salida (run vacío de Geant4)
+    fEventOffset = firstEvent;
+    G4RunManager::BeamOn(nLocal, macroFile, n_select);
+}
+
+// =============================================================
+// Bloques de K eventos con estado persistente
+// =============================================================
+void BatchRunManager::BeamOnWithCheckpoints(G4int runIndex, G4int firstEvent, G4int nEvents,
+                                            const char* macroFile, G4int n_select)
+{
+    // El espacio de fases se reescribe en cada run de Geant4: con bloques
+    // solo quedaría el último
+    if (PhaseSpace::Instance()->RecordRequested()) {
+        G4cerr << "Checkpoint: /phasespace/record no se admite con --checkpoint; run "
+               << runIndex << " no simulado" << G4endl;
+        fCheckpointsComplete = false;
+        return;
+    }
+
+    auto output = OutputConfig::Instance();
+    const G4String suffix = output->GetFileSuffix();
+    const G4String baseName = output->GetOutputName();
+    const G4String stateFile = baseName + ".ckpt";
+
+    CheckpointState state;
+    state.seed = fMasterSeed;
+    state.key = fCheckpointKey;
+    state.run = runIndex;
+    state.first = firstEvent;
+    state.events = nEvents;
+    state.interval = fCheckpointInterval;
+    state.next = firstEvent;
+
+    const G4int lastEvent = firstEvent + nEvents;
+    const G4int nBlocks = (nEvents + fCheckpointInterval - 1) / fCheckpointInterval;
+
+    std::vector<G4String> blocks;
+    for (G4int b = 0; b < nBlocks; ++b)
+        blocks.push_back(baseName + "_b" + std::to_string(b));
+
+    // ------------------------------------------------------------
+    // ¿Trabajo reiniciado? Solo cuenta el estado de la misma macro y
+    // semilla: el .ckpt de otro trabajo con la misma salida se ignora
+    // ------------------------------------------------------------
+    CheckpointState saved;
+    if (ReadState(stateFile, saved) && saved.SameJob(state)) {
+        if (saved.run > runIndex || (saved.SameRun(state) && saved.done)) {
+            G4cout << "Checkpoint: run " << runIndex << " ya completado (" << stateFile
+                   << "), se omite" << G4endl;
+            // Bloques que quedaron si el trabajo murió tras guardar el estado
+            if (saved.run == runIndex) RemoveOutputs(blocks);
+            fStateFiles.insert(stateFile);
+            return;
+        }
+        if (saved.SameRun(state)) {
+            state.next = std::clamp(saved.next, firstEvent, lastEvent);
+            G4cout << "Checkpoint: se reanuda el run " << runIndex << " en el evento "
+                   << state.next << " (" << state.next - firstEvent << "/" << nEvents
+                   << " eventos ya guardados)" << G4endl;
+        }
+    }
+    fStateFiles.insert(stateFile);
+
+    // ------------------------------------------------------------
+    // Bloques pendientes
+    // ------------------------------------------------------------
+    // state.next está en el límite de un bloque o es el final del rango
+    G4bool completed = true;
+    const G4int firstBlock = state.next >= lastEvent ? nBlocks
+                                                     : (state.next - firstEvent) / fCheckpointInterval;
+    for (G4int b = firstBlock; b < nBlocks; ++b) {
+        fEventOffset = firstEvent + b * fCheckpointInterval;
+        const G4int n = std::min(fCheckpointInterval, lastEvent - fEventOffset);
+
+        output->SetFileSuffix(suffix + "_b" + std::to_string(b));
+        G4RunManager::BeamOn(n, macroFile, n_select);
+        output->SetFileSuffix(suffix);
+
+        // Un bloque interrumpido (/run/abort) no se da por guardado
+        if (runAborted) {
+            completed = false;
+            break;
+        }
+
+        const G4String blockFile = blocks[b] + output->GetExtension();
+        if (!SyncPath(blockFile) || !SyncPath(blocks[b] + "_dict.csv")) {
+            G4cerr << "Checkpoint: no se pudo sincronizar " << blockFile << G4endl;
+            completed = false;
+            break;
+        }
+
+        state.next = fEventOffset + n;
+        if (!WriteState(stateFile, state)) {
+            G4cerr << "Checkpoint: no se pudo guardar " << stateFile << G4endl;
+            completed = false;
+            break;
+        }
+    }
+
+    if (!completed) {
+        fCheckpointsComplete = false;
+        return;
+    }
+
+    // ------------------------------------------------------------
+    // Fusión de los bloques en la salida del run. Orden: salida
+    // sustituida (MergeOutputs), estado "completado" y por último los
+    // bloques. Interrumpido antes del estado, el reinicio vuelve a
+    // fusionar los mismos bloques; después, omite el run.
+    // ------------------------------------------------------------
+    if (!MergeOutputs(blocks, baseName)) {
+        G4cerr << "Checkpoint: falló la fusión de los bloques de " << baseName << G4endl;
+        fCheckpointsComplete = false;
+        return;
+    }
+
+    state.done = 1;
+    if (!WriteState(stateFile, state)) {
+        G4cerr << "Checkpoint: no se pudo guardar " << stateFile << G4endl;
+        fCheckpointsComplete = false;
+        return;
+    }
+    RemoveOutputs(blocks);
+}
+
+// =============================================================
+// Trabajo terminado sin interrupciones: los .ckpt ya no hacen falta
+// y no deben afectar a otro trabajo con la misma salida
+// =============================================================
+void BatchRunManager::FinishCheckpoints()
+{
+    if (fCheckpointsComplete) {
+        for (const auto& stateFile : fStateFiles)
+            std::remove(stateFile.c_str());
+    }
+    fStateFiles.clear();
+}
+
+G4Event* BatchRunManager::GenerateEvent(G4int i_event)
+{
+    const G4int globalEvent = fEventOffset + i_event;
+
+    // Índice del /run/beamOn, no el runID de Geant4 (que avanza por bloque)
+    std::uint64_t state = fMasterSeed;
+    state ^= SplitMix64(state) + static_cast<std::uint64_t>(fCurrentRun);
+    state ^= SplitMix64(state) + static_cast<std::uint64_t>(globalEvent);
+
+    // Semillas positivas de 31 bits, válidas para cualquier motor de CLHEP
+    long seeds[3] = { static_cast<long>(SplitMix64(state) & 0x7FFFFFFF),
+                      static_cast<long>(SplitMix64(state) & 0x7FFFFFFF), 0 };
+    G4Random::setTheSeeds(seeds);
+
+    return G4RunManager::GenerateEvent(globalEvent);
+}
@@ -0,0 +1,96 @@
+#include "CaptureBiasingOperator.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4BOptnChangeCrossSection.hh"
+#include "G4BiasingProcessInterface.hh"
+#include "G4BiasingProcessSharedData.hh"
+#include "G4Neutron.hh"
+#include "G4ProcessManager.hh"
+#include "G4Track.hh"
+
+#include <cfloat>
+
+namespace {
+// Procesos del neutrón que terminan en captura
+G4bool IsCapture(const G4String& processName)
+{
+    return processName == "neutronInelastic" || processName == "nCapture";
+}
+}
+
+CaptureBiasingOperator::CaptureBiasingOperator(const DetectorConstruction* detector)
+: G4VBiasingOperator("CaptureBiasingOperator"),
+  fDetector(detector)
+{}
+
+CaptureBiasingOperator::~CaptureBiasingOperator()
+{
+    for (auto& entry : fOperations) delete entry.second;
+}
+
+// =============================================================
+// Factor del run (el maestro no lo cambia durante el run) y procesos
+// envueltos por G4GenericBiasingPhysics: las operaciones se crean una
+// vez, en el hilo del operador, cuando la física ya está construida
+// =============================================================
+void CaptureBiasingOperator::StartRun()
+{
+    fFactor = fDetector->GetCaptureBiasFactor();
+    if (!fOperations.empty()) return;
+
+    const auto sharedData = G4BiasingProcessInterface::GetSharedData(
+        G4Neutron::Definition()->GetProcessManager());
+    if (!sharedData) return;
+
+    for (const auto wrapper : sharedData->GetPhysicsBiasingProcessInterfaces()) {
+        const G4String& name = wrapper->GetWrappedProcess()->GetProcessName();
+        if (IsCapture(name))
+            fOperations[wrapper] = new G4BOptnChangeCrossSection("XSchange-" + name);
+    }
+}
+
+// =============================================================
+// Sección eficaz sesgada = factor x analógica, recalculada en cada
+// step (la analógica cambia con la energía del neutrón)
+// =============================================================
+G4VBiasingOperation* CaptureBiasingOperator::ProposeOccurenceBiasingOperation(
+    const G4Track* track, const G4BiasingProcessInterface* callingProcess)
+{
+    if (track->GetParentID() != 0 || track->GetDefinition() != G4Neutron::Definition())
+        return nullptr;
+
+    auto it = fOperations.find(callingProcess);
+    if (it == fOperations.end()) return nullptr;
+    G4BOptnChangeCrossSection* operation = it->second;
+
+    const G4double analogLength = callingProcess->GetWrappedProcess()->GetCurrentInteractionLength();
+    if (analogLength > DBL_MAX / 10.) return nullptr;
+    const G4double biasedXS = fFactor / analogLength;
+
+    // Primera propuesta en el volumen o tras una interacción: nuevo
+    // muestreo; si no, se descuenta el step recorrido y se conserva
+    // el número de recorridos libres pendiente
+    const auto previous = callingProcess->GetPreviousOccurenceBiasingOperation();
+    if (previous == nullptr || operation->GetInteractionOccured()) {
+        operation->SetBiasedCrossSection(biasedXS);
+        operation->Sample();
+    }
+    else {
+        operation->UpdateForStep(callingProcess->GetPreviousStepSize());
+        operation->SetBiasedCrossSection(biasedXS);
+        operation->UpdateForStep(0.);
+    }
+    return operation;
+}
+
+void CaptureBiasingOperator::OperationApplied(const G4BiasingProcessInterface* callingProcess,
+                                              G4BiasingAppliedCase,
+                                              G4VBiasingOperation* occurenceOperationApplied,
+                                              G4double,
+                                              G4VBiasingOperation*,
+                                              const G4VParticleChange*)
+{
+    auto it = fOperations.find(callingProcess);
+    if (it != fOperations.end() && it->second == occurenceOperationApplied)
+        it->second->SetInteractionOccured();
+}
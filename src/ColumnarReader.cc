@@ -0,0 +1,149 @@
+#include "ColumnarReader.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Lectura secuencial de la cabecera con verificación de límites
+class Cursor
+{
+public:
+    Cursor(const char* data, std::size_t size) : fData(data), fSize(size) {}
+
+    template <typename T>
+    T Read()
+    {
+        T value;
+        Need(sizeof(T));
+        std::memcpy(&value, fData + fOffset, sizeof(T));
+        fOffset += sizeof(T);
+        return value;
+    }
+
+    std::string ReadString()
+    {
+        const auto length = Read<std::uint32_t>();
+        Need(length);
+        std::string text(fData + fOffset, length);
+        fOffset += length;
+        return text;
+    }
+
+private:
+    void Need(std::size_t n) const
+    {
+        if (fOffset + n > fSize) throw std::runtime_error("ColumnarFile: cabecera truncada");
+    }
+
+    const char* fData;
+    std::size_t fSize;
+    std::size_t fOffset = sizeof(ColumnarFormat::kMagic);
+};
+
+}
+
+ColumnarFile::ColumnarFile(const std::string& path)
+{
+    using namespace ColumnarFormat;
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("ColumnarFile: no se pudo abrir " + path);
+
+    struct stat info;
+    fstat(fd, &info);
+    fSize = static_cast<std::size_t>(info.st_size);
+
+    void* data = (fSize >= sizeof(kMagic) + sizeof(Trailer))
+               ? mmap(nullptr, fSize, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);   // la proyección sigue siendo válida
+    if (data == MAP_FAILED) throw std::runtime_error("ColumnarFile: no se pudo proyectar " + path);
+    fData = static_cast<const char*>(data);
+
+    try {
+        if (std::memcmp(fData, kMagic, sizeof(kMagic)) != 0)
+            throw std::runtime_error("ColumnarFile: " + path + " no es un archivo columnar");
+
+        // --------------------------------------------------------
+        // Cola e índice (un archivo sin cola no se cerró)
+        // --------------------------------------------------------
+        Trailer trailer;
+        std::memcpy(&trailer, fData + fSize - sizeof(Trailer), sizeof(Trailer));
+        if (std::memcmp(trailer.magic, kEndMagic, sizeof(kEndMagic)) != 0 ||
+            trailer.indexOffset + trailer.nChunks * sizeof(ChunkIndex) > fSize - sizeof(Trailer))
+            throw std::runtime_error("ColumnarFile: " + path + " está incompleto");
+
+        // --------------------------------------------------------
+        // Esquema
+        // --------------------------------------------------------
+        Cursor cursor(fData, fSize);
+        const auto nNtuples = cursor.Read<std::uint32_t>();
+        cursor.Read<std::uint32_t>();
+        for (std::uint32_t n = 0; n < nNtuples; ++n) {
+            ColumnarNtupleInfo ntuple;
+            ntuple.name = cursor.ReadString();
+            ntuple.active = cursor.Read<std::uint8_t>() != 0;
+            const auto nColumns = cursor.Read<std::uint32_t>();
+            for (std::uint32_t c = 0; c < nColumns; ++c) {
+                ColumnarColumnInfo column;
+                column.name = cursor.ReadString();
+                column.type = static_cast<char>(cursor.Read<std::uint8_t>());
+                ntuple.columns.push_back(column);
+            }
+            fNtuples.push_back(ntuple);
+        }
+
+        // --------------------------------------------------------
+        // Bloques: punteros al mmap, sin copiar datos
+        // --------------------------------------------------------
+        fChunks.reserve(trailer.nChunks);
+        for (std::uint64_t i = 0; i < trailer.nChunks; ++i) {
+            ChunkIndex entry;
+            std::memcpy(&entry, fData + trailer.indexOffset + i * sizeof(ChunkIndex), sizeof(entry));
+
+            if (entry.ntuple >= fNtuples.size() ||
+                entry.column >= fNtuples[entry.ntuple].columns.size())
+                throw std::runtime_error("ColumnarFile: índice inválido en " + path);
+
+            const char type = fNtuples[entry.ntuple].columns[entry.column].type;
+            if (entry.offset % kAlignment != 0 ||
+                entry.offset + entry.nRows * TypeSize(type) > trailer.indexOffset)
+                throw std::runtime_error("ColumnarFile: bloque fuera del archivo en " + path);
+
+            fChunks.push_back({ entry.ntuple, entry.column, entry.nRows, fData + entry.offset });
+        }
+    }
+    catch (...) {
+        munmap(const_cast<char*>(fData), fSize);
+        throw;
+    }
+}
+
+ColumnarFile::~ColumnarFile()
+{
+    if (fData) munmap(const_cast<char*>(fData), fSize);
+}
+
+void ColumnarFile::Find(const std::string& ntuple, const std::string& column, char type,
+                        std::uint32_t& ntupleIndex, std::uint32_t& columnIndex) const
+{
+    for (std::uint32_t n = 0; n < fNtuples.size(); ++n) {
+        if (fNtuples[n].name != ntuple) continue;
+
+        const auto& columns = fNtuples[n].columns;
+        for (std::uint32_t c = 0; c < columns.size(); ++c) {
+            if (columns[c].name != column) continue;
+            if (columns[c].type != type)
+                throw std::runtime_error("ColumnarFile: " + ntuple + "." + column +
+                                         " es de tipo " + columns[c].type);
+            ntupleIndex = n;
+            columnIndex = c;
+            return;
+        }
+    }
+    throw std::runtime_error("ColumnarFile: no existe la columna " + ntuple + "." + column);
+}
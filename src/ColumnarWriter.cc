@@ -0,0 +1,298 @@
+#include "ColumnarWriter.hh"
+#include "RunAction.hh"
+
+#include "OutputConfig.hh"
+
+#include "G4AutoLock.hh"
+
+#include <cstring>
+#include <string>
+
+namespace {
+G4ThreadLocal ColumnarBuffer* fLocalBuffer = nullptr;
+
+// Búfer de stdio grande: los bloques son de cientos de kB
+constexpr std::size_t kFileBuffer = 1 << 22;
+}
+
+std::size_t ColumnarChunkData::Bytes() const
+{
+    std::size_t bytes = 0;
+    for (const auto& values : ints) bytes += values.size() * sizeof(std::int32_t);
+    for (const auto& values : doubles) bytes += values.size() * sizeof(G4double);
+    return bytes;
+}
+
+ColumnarWriter* ColumnarWriter::Instance()
+{
+    static ColumnarWriter* instance = new ColumnarWriter();
+    return instance;
+}
+
+// =============================================================
+// Archivo
+// =============================================================
+G4bool ColumnarWriter::Open(const G4String& fileName, const std::vector<G4bool>& active)
+{
+    using namespace ColumnarFormat;
+
+    Close();
+
+    G4AutoLock lock(&fFileMutex);
+    fFile = std::fopen(fileName.c_str(), "wb");
+    if (!fFile) {
+        G4cerr << "ColumnarWriter: no se pudo crear " << fileName << G4endl;
+        return false;
+    }
+    std::setvbuf(fFile, nullptr, _IOFBF, kFileBuffer);
+
+    fOffset = 0;
+    fIndex.clear();
+
+    // ------------------------------------------------------------
+    // Cabecera y esquema
+    // ------------------------------------------------------------
+    const auto& schemas = NtupleSchemas();
+    const std::uint32_t nNtuples = static_cast<std::uint32_t>(schemas.size());
+    const std::uint32_t reserved = 0;
+
+    WriteBytes(kMagic, sizeof(kMagic));
+    WriteBytes(&nNtuples, sizeof(nNtuples));
+    WriteBytes(&reserved, sizeof(reserved));
+
+    auto writeString = [this](const char* text) {
+        const std::uint32_t length = static_cast<std::uint32_t>(std::strlen(text));
+        WriteBytes(&length, sizeof(length));
+        WriteBytes(text, length);
+    };
+
+    for (std::size_t n = 0; n < schemas.size(); ++n) {
+        writeString(schemas[n].name);
+        const std::uint8_t isActive = (n < active.size() && active[n]) ? 1 : 0;
+        WriteBytes(&isActive, sizeof(isActive));
+
+        const std::uint32_t nColumns = static_cast<std::uint32_t>(schemas[n].columns.size());
+        WriteBytes(&nColumns, sizeof(nColumns));
+        for (const auto& column : schemas[n].columns) {
+            writeString(column.name);
+            const std::uint8_t type = static_cast<std::uint8_t>(column.type);
+            WriteBytes(&type, sizeof(type));
+        }
+    }
+    Pad();
+    lock.unlock();
+
+    // Hilo de escritura
+    fMemoryCap = static_cast<std::size_t>(OutputConfig::Instance()->GetWriterMemory()) << 20;
+    fStop = false;
+    fThread = std::thread(&ColumnarWriter::WriterLoop, this);
+
+    return true;
+}
+
+void ColumnarWriter::Close()
+{
+    if (!fFile) return;
+
+    using namespace ColumnarFormat;
+
+    // Vaciar la cola y parar el hilo de escritura
+    if (fThread.joinable()) {
+        {
+            G4AutoLock lock(&fQueueMutex);
+            fStop = true;
+        }
+        fQueueReady.notify_all();
+        fThread.join();
+    }
+
+    G4AutoLock lock(&fFileMutex);
+
+    // Índice de bloques y cola
+    Trailer trailer{};
+    trailer.nChunks = fIndex.size();
+    trailer.indexOffset = fOffset;
+    std::memcpy(trailer.magic, kEndMagic, sizeof(kEndMagic));
+
+    if (!fIndex.empty())
+        WriteBytes(fIndex.data(), fIndex.size() * sizeof(ChunkIndex));
+    WriteBytes(&trailer, sizeof(trailer));
+
+    std::fclose(fFile);
+    fFile = nullptr;
+    fIndex.clear();
+}
+
+// =============================================================
+// Cola del hilo de escritura
+// =============================================================
+std::unique_ptr<ColumnarChunkData> ColumnarWriter::Acquire(std::uint32_t ntuple)
+{
+    std::unique_ptr<ColumnarChunkData> chunk;
+    {
+        G4AutoLock lock(&fQueueMutex);
+        if (!fFree.empty()) {
+            chunk = std::move(fFree.back());
+            fFree.pop_back();
+        }
+    }
+    if (!chunk) chunk = std::make_unique<ColumnarChunkData>();
+
+    // Un vector por columna de cada tipo; los del otro tipo quedan vacíos
+    const std::size_t nColumns = NtupleSchemas()[ntuple].columns.size();
+    chunk->ntuple = ntuple;
+    chunk->nRows = 0;
+    chunk->ints.resize(nColumns);
+    chunk->doubles.resize(nColumns);
+    for (auto& values : chunk->ints) values.clear();
+    for (auto& values : chunk->doubles) values.clear();
+    return chunk;
+}
+
+void ColumnarWriter::Submit(std::unique_ptr<ColumnarChunkData> chunk)
+{
+    const std::size_t bytes = chunk->Bytes();
+
+    G4AutoLock lock(&fQueueMutex);
+
+    // Sin hilo de escritura (archivo cerrado) el bloque se descarta
+    if (!fThread.joinable()) {
+        fFree.push_back(std::move(chunk));
+        return;
+    }
+
+    // Tope de memoria: se espera a que el hilo de escritura vacíe la cola
+    // (un bloque solo entra siempre, aunque supere el tope)
+    fQueueSpace.wait(lock, [&] { return fQueue.empty() || fQueuedBytes + bytes <= fMemoryCap; });
+
+    fQueuedBytes += bytes;
+    fQueue.push_back(std::move(chunk));
+    lock.unlock();
+    fQueueReady.notify_one();
+}
+
+void ColumnarWriter::WriterLoop()
+{
+    G4AutoLock lock(&fQueueMutex);
+    while (true) {
+        fQueueReady.wait(lock, [&] { return fStop || !fQueue.empty(); });
+        if (fQueue.empty()) return;   // fStop y nada pendiente
+
+        auto chunk = std::move(fQueue.front());
+        fQueue.pop_front();
+        lock.unlock();
+
+        WriteChunkData(*chunk);
+        const std::size_t bytes = chunk->Bytes();
+
+        lock.lock();
+        fQueuedBytes -= bytes;
+        fFree.push_back(std::move(chunk));
+        fQueueSpace.notify_all();
+    }
+}
+
+// =============================================================
+// Escritura de un bloque: todas sus columnas seguidas
+// =============================================================
+void ColumnarWriter::WriteChunkData(const ColumnarChunkData& chunk)
+{
+    const auto& schema = NtupleSchemas()[chunk.ntuple];
+
+    std::vector<ColumnData> columns;
+    columns.reserve(schema.columns.size());
+    for (std::size_t c = 0; c < schema.columns.size(); ++c) {
+        const void* data = (schema.columns[c].type == 'I')
+                         ? static_cast<const void*>(chunk.ints[c].data())
+                         : static_cast<const void*>(chunk.doubles[c].data());
+        columns.push_back({ static_cast<std::uint32_t>(c), data, chunk.nRows });
+    }
+    WriteChunk(chunk.ntuple, columns);
+}
+
+void ColumnarWriter::WriteChunk(std::uint32_t ntuple, const std::vector<ColumnData>& columns)
+{
+    using namespace ColumnarFormat;
+
+    const auto& schema = NtupleSchemas()[ntuple];
+
+    G4AutoLock lock(&fFileMutex);
+    if (!fFile) return;
+
+    for (const auto& column : columns) {
+        const ChunkHeader header{ ntuple, column.column, column.nRows };
+        WriteBytes(&header, sizeof(header));
+
+        fIndex.push_back({ ntuple, column.column, column.nRows, fOffset });
+        WriteBytes(column.data, column.nRows * TypeSize(schema.columns[column.column].type));
+        Pad();
+    }
+}
+
+void ColumnarWriter::WriteBytes(const void* data, std::size_t size)
+{
+    std::fwrite(data, 1, size, fFile);
+    fOffset += size;
+}
+
+void ColumnarWriter::Pad()
+{
+    static const char zeros[ColumnarFormat::kAlignment] = {};
+    WriteBytes(zeros, ColumnarFormat::Padding(fOffset));
+}
+
+// =============================================================
+// Búfer por hilo
+// =============================================================
+ColumnarBuffer* ColumnarBuffer::Local()
+{
+    if (!fLocalBuffer) fLocalBuffer = new ColumnarBuffer();
+    return fLocalBuffer;
+}
+
+void ColumnarBuffer::Reset()
+{
+    const auto& schemas = NtupleSchemas();
+    fNtuples.clear();
+    fNtuples.resize(schemas.size());
+
+    for (std::size_t n = 0; n < schemas.size(); ++n) {
+        auto& ntuple = fNtuples[n];
+        const std::size_t nColumns = schemas[n].columns.size();
+
+        for (const auto& column : schemas[n].columns)
+            ntuple.types.push_back(column.type);
+        ntuple.intRow.assign(nColumns, 0);
+        ntuple.doubleRow.assign(nColumns, 0.);
+        ntuple.chunk = ColumnarWriter::Instance()->Acquire(static_cast<std::uint32_t>(n));
+    }
+}
+
+void ColumnarBuffer::AddNtupleRow(G4int id)
+{
+    auto& ntuple = fNtuples[id];
+    auto& chunk = *ntuple.chunk;
+    for (std::size_t c = 0; c < ntuple.types.size(); ++c) {
+        if (ntuple.types[c] == 'I') chunk.ints[c].push_back(ntuple.intRow[c]);
+        else                        chunk.doubles[c].push_back(ntuple.doubleRow[c]);
+    }
+
+    if (++chunk.nRows == kChunkRows) Flush(id);
+}
+
+void ColumnarBuffer::Flush()
+{
+    for (std::size_t n = 0; n < fNtuples.size(); ++n)
+        Flush(static_cast<G4int>(n));
+}
+
+void ColumnarBuffer::Flush(G4int id)
+{
+    auto& ntuple = fNtuples[id];
+    if (!ntuple.chunk || ntuple.chunk->nRows == 0) return;
+
+    // Doble búfer: el bloque lleno va a la cola y se sigue en uno reciclado
+    auto writer = ColumnarWriter::Instance();
+    writer->Submit(std::move(ntuple.chunk));
+    ntuple.chunk = writer->Acquire(static_cast<std::uint32_t>(id));
+}
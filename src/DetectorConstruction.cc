@@ -1,13 +1,19 @@
 // DetectorConstruction.cc
 #include "DetectorConstruction.hh"
+#include "CaptureBiasingOperator.hh"
 #include "ScintSD.hh"
 #include "OpticalSiPM_SD.hh"
+#include "OpticalFastModel.hh"
+#include "StartupTimer.hh"
+#include "MasterCommand.hh"
 
 #include "G4Material.hh"
 #include "G4NistManager.hh"
 #include "G4Box.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
+#include "G4PVReplica.hh"
+#include "G4VTouchable.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
@@ -16,25 +22,198 @@
 #include "G4LogicalVolumeStore.hh"
 #include "G4ProductionCuts.hh"
 #include "G4Region.hh"
+#include "G4RegionStore.hh"
 #include "G4SDManager.hh"
 #include "G4UserLimits.hh"
+#include "G4RunManager.hh"
+#include "G4GenericMessenger.hh"
+#include "G4ApplicationState.hh"
+#include "G4UIcommand.hh"
+#include "G4FastSimulationManager.hh"
 
 #include "G4LogicalBorderSurface.hh"
 #include "G4OpticalSurface.hh"
 #include "G4MaterialPropertiesTable.hh"
 
+#include <algorithm>
+#include <sstream>
+
 DetectorConstruction::DetectorConstruction()
 : G4VUserDetectorConstruction(),
-  fScintType(ScintType::PLASTIC)   // Cambia aquí el tipo de centellador
-{}
+  fScintType(ScintType::PLASTIC),   // Cambia aquí el tipo de centellador
+  fSiPMSize(4.7*cm, 4.7*cm, 1*mm),
+  fGraphThickness(50*nm),
+  fKapThickness(1*um)
+{
+    SetScintType(fScintType);
+
+    // ------------------------------------------------------------
+    // Comandos /det/ para barridos de diseño en un mismo proceso
+    // ------------------------------------------------------------
+    fMessenger = new G4GenericMessenger(this, "/det/", "Geometría del detector");
+
+    auto& typeCmd = fMessenger->DeclareMethod("scintType", &DetectorConstruction::SetScintTypeByName,
+        "Tipo de centellador; fija también sus dimensiones por defecto "
+        "(usar /det/scintSize después para cambiarlas).");
+    typeCmd.SetParameterName("type", false);
+    typeCmd.SetCandidates("plastic bgo csi lyso");
+    MasterOnly(typeCmd);
+
+    auto& scintCmd = fMessenger->DeclareMethod("scintSize", &DetectorConstruction::SetScintSize,
+        "Dimensiones completas del centellador: X Y Z unidad (p.ej. 7 7 16 mm).");
+    scintCmd.SetParameterName("size", false);
+    MasterOnly(scintCmd);
+
+    auto& sipmCmd = fMessenger->DeclareMethod("sipmSize", &DetectorConstruction::SetSiPMSize,
+        "Dimensiones completas del SiPM: X Y Z unidad (p.ej. 6 6 1 mm).");
+    sipmCmd.SetParameterName("size", false);
+    MasterOnly(sipmCmd);
+
+    auto& graphCmd = fMessenger->DeclareMethodWithUnit("grapheneThickness", "nm",
+        &DetectorConstruction::SetGrapheneThickness, "Espesor de la capa de grafeno con boro.");
+    graphCmd.SetParameterName("thickness", false);
+    graphCmd.SetRange("thickness>0.");
+    MasterOnly(graphCmd);
+
+    auto& kapCmd = fMessenger->DeclareMethodWithUnit("kaptonThickness", "um",
+        &DetectorConstruction::SetKaptonThickness, "Espesor del sustrato de Kapton.");
+    kapCmd.SetParameterName("thickness", false);
+    kapCmd.SetRange("thickness>0.");
+    MasterOnly(kapCmd);
+
+    auto& arrayCmd = fMessenger->DeclareMethod("array", &DetectorConstruction::SetArray,
+        "Matriz de NX x NY centelladores, cada uno con su SiPM (p.ej. 8 8; 1 1 = una pieza).");
+    arrayCmd.SetParameterName("nxny", false);
+    MasterOnly(arrayCmd);
+
+    auto& gapCmd = fMessenger->DeclareMethodWithUnit("arrayGap", "mm",
+        &DetectorConstruction::SetArrayGap, "Separación (aire) entre celdas de la matriz.");
+    gapCmd.SetParameterName("gap", false);
+    gapCmd.SetRange("gap>=0.");
+    MasterOnly(gapCmd);
+
+    // Los operadores de cada hilo lo leen al empezar el run
+    auto& biasCmd = fMessenger->DeclareMethod("biasFactor", &DetectorConstruction::SetCaptureBiasFactor,
+        "Factor de la sección eficaz de captura del neutrón primario en el grafeno (--bias).");
+    biasCmd.SetParameterName("factor", false);
+    biasCmd.SetRange("factor>=1.");
+    MasterOnly(biasCmd);
+}
 
-DetectorConstruction::~DetectorConstruction() = default;
+DetectorConstruction::~DetectorConstruction()
+{
+    delete fMessenger;
+}
+
+//
+// -------------------------------------------
+// PARÁMETROS DE GEOMETRÍA
+// -------------------------------------------
+//
+void DetectorConstruction::SetScintType(ScintType t)
+{
+    fScintType = t;
+
+    if (fScintType == ScintType::PLASTIC)
+        fScintSize = G4ThreeVector(4.7*cm, 4.7*cm, 1.0*cm);
+    else
+        // Cristales: BGO, LYSO, CsI:Tl
+        fScintSize = G4ThreeVector(7.0*mm, 7.0*mm, 16.0*mm);
+
+    GeometryChanged();
+}
+
+void DetectorConstruction::SetScintTypeByName(const G4String& name)
+{
+    if      (name == "bgo")  SetScintType(ScintType::BGO);
+    else if (name == "csi")  SetScintType(ScintType::CSI);
+    else if (name == "lyso") SetScintType(ScintType::LYSO);
+    else                     SetScintType(ScintType::PLASTIC);
+}
+
+void DetectorConstruction::SetScintSize(const G4String& values)
+{
+    const G4ThreeVector size = G4UIcommand::ConvertToDimensioned3Vector(values);
+    if (size.x() <= 0. || size.y() <= 0. || size.z() <= 0.) {
+        G4cerr << "/det/scintSize: se esperan tres longitudes positivas y la unidad" << G4endl;
+        return;
+    }
+    fScintSize = size;
+    GeometryChanged();
+}
+
+void DetectorConstruction::SetSiPMSize(const G4String& values)
+{
+    const G4ThreeVector size = G4UIcommand::ConvertToDimensioned3Vector(values);
+    if (size.x() <= 0. || size.y() <= 0. || size.z() <= 0.) {
+        G4cerr << "/det/sipmSize: se esperan tres longitudes positivas y la unidad" << G4endl;
+        return;
+    }
+    fSiPMSize = size;
+    GeometryChanged();
+}
+
+void DetectorConstruction::SetGrapheneThickness(G4double value)
+{
+    fGraphThickness = value;
+    GeometryChanged();
+}
+
+void DetectorConstruction::SetKaptonThickness(G4double value)
+{
+    fKapThickness = value;
+    GeometryChanged();
+}
+
+void DetectorConstruction::SetArray(const G4String& values)
+{
+    std::istringstream in(values);
+    G4int nx = 0, ny = 0;
+    if (!(in >> nx >> ny) || nx < 1 || ny < 1) {
+        G4cerr << "/det/array: se esperan dos enteros positivos NX NY" << G4endl;
+        return;
+    }
+    fArrayNx = nx;
+    fArrayNy = ny;
+    GeometryChanged();
+}
+
+void DetectorConstruction::SetArrayGap(G4double value)
+{
+    fArrayGap = value;
+    GeometryChanged();
+}
+
+void DetectorConstruction::GeometryChanged()
+{
+    // Antes de inicializar basta con guardar el valor
+    if (!fPhysWorld) return;
+
+    // Se borran volúmenes, sólidos y superficies; materiales, regiones,
+    // SDs y tablas de física se conservan. Los workers reconstruyen su
+    // geometría al empezar el siguiente run.
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+    fPhysWorld = nullptr;
+}
 
 //
 // -------------------------------------------
 // MATERIALES DEL CENTELLADOR + PROPIEDADES ÓPTICAS
 // -------------------------------------------
 //
+G4Material* DetectorConstruction::GetScintillatorMaterial()
+{
+    // Un material (y una tabla de propiedades ópticas) por tipo, creado
+    // la primera vez que se usa: al cambiar de centellador no se reserva nada
+    auto it = fScintMaterials.find(fScintType);
+    if (it != fScintMaterials.end())
+        return it->second;
+
+    auto mat = CreateScintillatorMaterial();
+    fScintMaterials[fScintType] = mat;
+    return mat;
+}
+
 G4Material* DetectorConstruction::CreateScintillatorMaterial()
 {
     auto nist = G4NistManager::Instance();
@@ -167,20 +346,17 @@ void DetectorConstruction::DefineOpticalProperties(G4Material* scintMat)
 // CONSTRUCCIÓN DEL DETECTOR
 // -------------------------------------------
 //
-G4VPhysicalVolume* DetectorConstruction::Construct()
+void DetectorConstruction::DefineMaterials()
 {
+    if (fMaterialsDefined) return;
+    fMaterialsDefined = true;
+
     auto nist = G4NistManager::Instance();
 
     // ============================
-    // WORLD
+    // AIRE
     // ============================
-    auto worldMat = nist->FindOrBuildMaterial("G4_AIR");
-    auto solidWorld = new G4Box("World", 20*cm, 20*cm, 20*cm);
-    auto logicWorld = new G4LogicalVolume(solidWorld, worldMat, "World");
-    auto physWorld  = new G4PVPlacement(nullptr, {}, logicWorld, "World", 0, false, 0);
-
-    logicWorld->SetVisAttributes(G4VisAttributes::GetInvisible());
-    fPhysWorld = physWorld;
+    fWorldMat = nist->FindOrBuildMaterial("G4_AIR");
 
     // Propiedades ópticas del aire (para que los fotones puedan viajar)
     {
@@ -190,7 +366,7 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 
         auto mptWorld = new G4MaterialPropertiesTable();
         mptWorld->AddProperty("RINDEX", photonE, rindex, n);
-        worldMat->SetMaterialPropertiesTable(mptWorld);
+        fWorldMat->SetMaterialPropertiesTable(mptWorld);
     }
 
     // ============================
@@ -203,15 +379,86 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     elB_enriched->AddIsotope(B10, 100*perCent);
     elB_enriched->AddIsotope(B11, 0);
 
-    auto graphene = new G4Material("graphene", 2.2*g/cm3, 2);
-    graphene->AddElement(nist->FindOrBuildElement("C"), 0.85);
-    graphene->AddElement(elB_enriched, 0.15);
+    fGrapheneMat = new G4Material("graphene", 2.2*g/cm3, 2);
+    fGrapheneMat->AddElement(nist->FindOrBuildElement("C"), 0.85);
+    fGrapheneMat->AddElement(elB_enriched, 0.15);
+
+    // ============================
+    // KAPTON
+    // ============================
+    fKaptonMat = nist->FindOrBuildMaterial("G4_KAPTON");
+
+    // ============================
+    // SILICIO (SiPM)
+    // ============================
+    fSiPMMat = nist->FindOrBuildMaterial("G4_Si");
 
-    G4double graphThickness = 50*nm;
-    G4double graphHalfZ = graphThickness/2.0;
+    // Propiedades ópticas del Silicio
+    {
+        const G4int nSi = 2;
+        G4double eSi[nSi]   = { 2.0*eV, 3.5*eV };
+        G4double rSi[nSi]   = { 3.5, 3.5 };         // índice alto del Si
+        G4double absSi[nSi] = { 0.001*mm, 0.001*mm }; // muy absorbente
 
-    auto solidGraph = new G4Box("graphene", 1*cm, 1*cm, graphHalfZ);
-    auto logicGraph = new G4LogicalVolume(solidGraph, graphene, "graphene");
+        auto mptSi = new G4MaterialPropertiesTable();
+        mptSi->AddProperty("RINDEX",    eSi, rSi,   nSi);
+        mptSi->AddProperty("ABSLENGTH", eSi, absSi, nSi);
+        fSiPMMat->SetMaterialPropertiesTable(mptSi);
+    }
+
+    // Eficiencia cuántica de la superficie Scintillator–SiPM (PDE simplificada).
+    // La superficie se recrea con la geometría; su tabla no.
+    {
+        fSurfaceMPT = new G4MaterialPropertiesTable();
+        const G4int num = 2;
+        G4double pp[num] = {2.0*eV, 3.5*eV};
+        G4double efficiency[num] = {1.0, 1.0}; 
+
+        fSurfaceMPT->AddProperty("EFFICIENCY", pp, efficiency, num);
+    }
+}
+
+//
+// -------------------------------------------
+// CONSTRUCCIÓN DEL DETECTOR
+// -------------------------------------------
+//
+G4VPhysicalVolume* DetectorConstruction::Construct()
+{
+    // Desglose del arranque (--timing)
+    StartupTimer::Measure measure("materiales y geometría");
+
+    DefineMaterials();
+
+    // ============================
+    // MATRIZ (/det/array): paso de la celda centellador + SiPM
+    // ============================
+    const G4bool array = GetNumberOfChannels() > 1;
+    const G4double pitchX = std::max(fScintSize.x(), fSiPMSize.x()) + fArrayGap;
+    const G4double pitchY = std::max(fScintSize.y(), fSiPMSize.y()) + fArrayGap;
+    const G4double arrayHalfX = array ? 0.5 * fArrayNx * pitchX : 0.;
+    const G4double arrayHalfY = array ? 0.5 * fArrayNy * pitchY : 0.;
+
+    // ============================
+    // WORLD
+    // ============================
+    auto worldMat = fWorldMat;
+    const G4double worldHalfXY = std::max(20*cm, std::max(arrayHalfX, arrayHalfY) + 1*cm);
+    auto solidWorld = new G4Box("World", worldHalfXY, worldHalfXY, 20*cm);
+    auto logicWorld = new G4LogicalVolume(solidWorld, worldMat, "World");
+    auto physWorld  = new G4PVPlacement(nullptr, {}, logicWorld, "World", 0, false, 0);
+
+    logicWorld->SetVisAttributes(G4VisAttributes::GetInvisible());
+    fPhysWorld = physWorld;
+
+    // ============================
+    // GRAPHENE + BORO-10 (cubre toda la matriz)
+    // ============================
+    G4double graphHalfZ = fGraphThickness/2.0;
+
+    auto solidGraph = new G4Box("graphene", std::max(1*cm, arrayHalfX), std::max(1*cm, arrayHalfY),
+                                graphHalfZ);
+    auto logicGraph = new G4LogicalVolume(solidGraph, fGrapheneMat, "graphene");
 
     auto physGraph = new G4PVPlacement(nullptr, {0,0,0}, logicGraph,
                                        "graphene", logicWorld, false, 0);
@@ -223,13 +470,13 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     // ============================
     // KAPTON
     // ============================
-    G4double kapThickness = 1*um;
-    G4double kapHalfZ = kapThickness/2.0;
+    G4double kapHalfZ = fKapThickness/2.0;
 
-    auto kaptonMat = nist->FindOrBuildMaterial("G4_KAPTON");
+    auto kaptonMat = fKaptonMat;
     G4double kapZ = graphHalfZ + kapHalfZ;
 
-    auto solidKap = new G4Box("kapton", 1.5*cm, 1.5*cm, kapHalfZ);
+    auto solidKap = new G4Box("kapton", std::max(1.5*cm, arrayHalfX), std::max(1.5*cm, arrayHalfY),
+                              kapHalfZ);
     auto logicKap = new G4LogicalVolume(solidKap, kaptonMat, "kapton");
 
     auto physKap = new G4PVPlacement(nullptr, {0,0,kapZ}, logicKap,
@@ -240,38 +487,65 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     logicKap->SetVisAttributes(visKap);
 
     // ============================
-    // CENTELLADOR (dimensiones según tipo)
+    // CENTELLADOR (dimensiones según tipo o /det/scintSize)
     // ============================
-    G4double scintX, scintY, scintZ, scintHalfZ;
+    G4double scintX = fScintSize.x();
+    G4double scintY = fScintSize.y();
+    G4double scintZ = fScintSize.z();
+    G4double scintHalfZ = scintZ/2.0;
 
-    if (fScintType == ScintType::PLASTIC)
-    {
-        //
-        scintX = 4.7*cm;
-        scintY = 4.7*cm;
-        scintZ = 1.0*cm;
-    }
-    else
-    {
-        // Cristales: BGO, LYSO, CsI:Tl
-        scintX = 7.0*mm;
-        scintY = 7.0*mm;
-        scintZ = 16.0*mm;
-    }
-
-    scintHalfZ = scintZ/2.0;
+    G4double sipmX = fSiPMSize.x();
+    G4double sipmY = fSiPMSize.y();
+    G4double sipmZ = fSiPMSize.z();
 
     // Centro del centellador en Z
     G4double scintZpos = graphHalfZ + scintHalfZ;
 
-    auto scintMat = CreateScintillatorMaterial();
+    // Posición del SiPM: tocando el centellador (sin gap)
+    G4double sipmZpos = scintZpos + scintHalfZ + sipmZ/2.0;
+
+    // Volumen madre del centellador y del SiPM: el mundo, o la celda de
+    // la matriz (con coordenadas locales a la celda)
+    G4LogicalVolume* logicMother = logicWorld;
+
+    if (array) {
+        // Envolvente -> NX columnas (réplica en X) -> NY celdas (réplica
+        // en Y). Un solo centellador, un solo SiPM y una sola superficie
+        // óptica dentro de la celda sirven para todos los canales: la
+        // memoria y la inicialización no crecen con la matriz y la
+        // navegación entre celdas es directa (sin vóxeles).
+        const G4double cellHalfZ = 0.5 * (scintZ + sipmZ);
+
+        auto solidArray = new G4Box("ScintArray", arrayHalfX, arrayHalfY, cellHalfZ);
+        auto logicArray = new G4LogicalVolume(solidArray, worldMat, "ScintArray");
+        new G4PVPlacement(nullptr, {0, 0, graphHalfZ + cellHalfZ}, logicArray,
+                          "ScintArray", logicWorld, false, 0);
+
+        auto solidColumn = new G4Box("ArrayColumn", 0.5*pitchX, arrayHalfY, cellHalfZ);
+        auto logicColumn = new G4LogicalVolume(solidColumn, worldMat, "ArrayColumn");
+        new G4PVReplica("ArrayColumn", logicColumn, logicArray, kXAxis, fArrayNx, pitchX);
+
+        auto solidCell = new G4Box("ArrayCell", 0.5*pitchX, 0.5*pitchY, cellHalfZ);
+        auto logicCell = new G4LogicalVolume(solidCell, worldMat, "ArrayCell");
+        new G4PVReplica("ArrayCell", logicCell, logicColumn, kYAxis, fArrayNy, pitchY);
+
+        logicArray->SetVisAttributes(G4VisAttributes::GetInvisible());
+        logicColumn->SetVisAttributes(G4VisAttributes::GetInvisible());
+        logicCell->SetVisAttributes(G4VisAttributes::GetInvisible());
+
+        logicMother = logicCell;
+        scintZpos = -cellHalfZ + scintHalfZ;
+        sipmZpos = cellHalfZ - sipmZ/2.0;
+    }
+
+    auto scintMat = GetScintillatorMaterial();
 
     auto solidScint = new G4Box("Scintillator",
                                 scintX/2.0, scintY/2.0, scintHalfZ);
     auto logicScint = new G4LogicalVolume(solidScint, scintMat, "Scintillator");
 
     auto physScint = new G4PVPlacement(nullptr, {0,0,scintZpos}, logicScint,
-                                       "Scintillator", logicWorld, false, 0);
+                                       "Scintillator", logicMother, false, 0);
 
     auto visScint = new G4VisAttributes(G4Colour(0.0, 0.0, 1.0, 0.3));
     visScint->SetForceSolid(true);
@@ -280,54 +554,26 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     // ============================
     // SiPM
     // ============================
-    G4double sipmX = 4.7*cm;
-    G4double sipmY = 4.7*cm; //5mm
-    G4double sipmZ = 1*mm;
-
     auto solidSiPM = new G4Box("SiPM", sipmX/2, sipmY/2, sipmZ/2);
-    auto sipmMat = nist->FindOrBuildMaterial("G4_Si");
-
-    // Propiedades ópticas del Silicio
-    {
-        const G4int nSi = 2;
-        G4double eSi[nSi]   = { 2.0*eV, 3.5*eV };
-        G4double rSi[nSi]   = { 3.5, 3.5 };         // índice alto del Si
-        G4double absSi[nSi] = { 0.001*mm, 0.001*mm }; // muy absorbente
-
-        auto mptSi = new G4MaterialPropertiesTable();
-        mptSi->AddProperty("RINDEX",    eSi, rSi,   nSi);
-        mptSi->AddProperty("ABSLENGTH", eSi, absSi, nSi);
-        sipmMat->SetMaterialPropertiesTable(mptSi);
-    }
+    auto sipmMat = fSiPMMat;
 
     auto logicSiPM = new G4LogicalVolume(solidSiPM, sipmMat, "SiPM");
 
-    // Posición del SiPM: tocando el centellador (sin gap)
-    G4double sipmZpos = scintZpos + scintHalfZ + sipmZ/2.0;
-
     auto physSiPM = new G4PVPlacement(nullptr, {0,0,sipmZpos}, logicSiPM,
-                                      "SiPM", logicWorld, false, 0);
+                                      "SiPM", logicMother, false, 0);
 
     auto visSiPM = new G4VisAttributes(G4Colour(1.0, 0.0, 1.0, 1.0));
     visSiPM->SetForceSolid(true);
     logicSiPM->SetVisAttributes(visSiPM);
 
     // ============================
-    // Superficie óptica Scintillator–SiPM
+    // Superficie óptica Scintillator–SiPM (compartida por todos los canales)
     // ============================
     auto optSurf = new G4OpticalSurface("ScintToSiPM");
     optSurf->SetType(dielectric_dielectric);
     optSurf->SetModel(unified);
     optSurf->SetFinish(polished);
-
-    // Eficiencia cuántica (PDE simplificada)
-    auto mptSurf = new G4MaterialPropertiesTable();
-    const G4int num = 2;
-    G4double pp[num] = {2.0*eV, 3.5*eV};
-    G4double efficiency[num] = {1.0, 1.0}; 
-
-    mptSurf->AddProperty("EFFICIENCY", pp, efficiency, num);
-    optSurf->SetMaterialPropertiesTable(mptSurf);
+    optSurf->SetMaterialPropertiesTable(fSurfaceMPT);
 
     new G4LogicalBorderSurface("Scint_SiPM_Surface",
                                physScint, physSiPM, optSurf);
@@ -335,21 +581,63 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
     // ============================
     // Production cuts & Regions
     // ============================
-    auto cuts = new G4ProductionCuts();
-    cuts->SetProductionCut(0.01*mm, G4ProductionCuts::GetIndex("gamma"));
-    cuts->SetProductionCut(0.01*mm, G4ProductionCuts::GetIndex("neutron"));
+    // Las regiones sobreviven a ReinitializeGeometry: se reutilizan por
+    // nombre y solo se les añaden los nuevos volúmenes lógicos
+    auto regionStore = G4RegionStore::GetInstance();
+    auto region = regionStore->GetRegion("DetectorRegion", false);
+    auto scintRegion = regionStore->GetRegion("ScintRegion", false);
+
+    if (!region)
+    {
+        auto cuts = new G4ProductionCuts();
+        cuts->SetProductionCut(0.01*mm, G4ProductionCuts::GetIndex("gamma"));
+        cuts->SetProductionCut(0.01*mm, G4ProductionCuts::GetIndex("neutron"));
+
+        region = new G4Region("DetectorRegion");
+        region->SetProductionCuts(cuts);
+
+        // El centellador va en su propia región (mismos cortes) para que
+        // sirva de envolvente del modelo óptico rápido
+        scintRegion = new G4Region("ScintRegion");
+        scintRegion->SetProductionCuts(cuts);
+    }
 
-    auto region = new G4Region("DetectorRegion");
     region->AddRootLogicalVolume(logicGraph);
     region->AddRootLogicalVolume(logicKap);
-    region->AddRootLogicalVolume(logicScint);
-    region->SetProductionCuts(cuts);
+    scintRegion->AddRootLogicalVolume(logicScint);
+
+    G4cout << "=== SCINT SELECTED: " << (int)fScintType
+           << "  " << scintX/mm << " x " << scintY/mm << " x " << scintZ/mm << " mm";
+    if (array)
+        G4cout << "  matriz " << fArrayNx << " x " << fArrayNy << " (paso "
+               << pitchX/mm << " x " << pitchY/mm << " mm)";
+    G4cout << G4endl;
 
     return physWorld;
-    G4cout << "=== SCINT SELECTED: " << (int)fScintType << G4endl;
 }
 
 
+G4ThreeVector DetectorConstruction::GetSiPMPlaneHalfSize() const
+{
+    if (GetNumberOfChannels() <= 1) return 0.5 * fSiPMSize;
+
+    // Mismo paso de celda que en Construct
+    const G4double pitchX = std::max(fScintSize.x(), fSiPMSize.x()) + fArrayGap;
+    const G4double pitchY = std::max(fScintSize.y(), fSiPMSize.y()) + fArrayGap;
+    return G4ThreeVector(0.5 * fArrayNx * pitchX, 0.5 * fArrayNy * pitchY, 0.5 * fSiPMSize.z());
+}
+
+G4int DetectorConstruction::GetChannel(const G4VTouchable* touchable)
+{
+    // Historia en la matriz: 0 centellador/SiPM, 1 celda (iy), 2 columna (ix)
+    if (touchable->GetHistoryDepth() < 3) return 0;
+
+    const G4VPhysicalVolume* cell = touchable->GetVolume(1);
+    if (!cell->IsReplicated()) return 0;
+
+    return touchable->GetReplicaNumber(2) * cell->GetMultiplicity() + touchable->GetReplicaNumber(1);
+}
+
 //
 // -------------------------------------------
 // SENSITIVE DETECTORS
@@ -357,21 +645,46 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 //
 void DetectorConstruction::ConstructSDandField()
 {
+    // Se llama una vez por hilo: cada worker tiene sus propias instancias
+    // de los SD, así que sus acumuladores por evento no se comparten.
+    // Tras /det/... se vuelve a llamar: los SDs (y sus colecciones) ya
+    // registrados se reutilizan y solo se asignan a los nuevos volúmenes.
     auto sdManager = G4SDManager::GetSDMpointer();
 
     // SD del centellador
-    auto scintSD = new ScintSD("ScintSD");
-    sdManager->AddNewDetector(scintSD);
-
-    auto lvScint = G4LogicalVolumeStore::GetInstance()->GetVolume("Scintillator");
-    if (lvScint)
-        lvScint->SetSensitiveDetector(scintSD);
+    auto scintSD = static_cast<ScintSD*>(sdManager->FindSensitiveDetector("ScintSD", false));
+    if (!scintSD) {
+        scintSD = new ScintSD("ScintSD");
+        sdManager->AddNewDetector(scintSD);
+    }
+    SetSensitiveDetector("Scintillator", scintSD);
 
     // SD del SiPM
-    auto sipmSD = new OpticalSiPM_SD("SiPM_SD");
-    sdManager->AddNewDetector(sipmSD);
-
-    auto lvSiPM = G4LogicalVolumeStore::GetInstance()->GetVolume("SiPM");
-    if (lvSiPM)
-        lvSiPM->SetSensitiveDetector(sipmSD);
+    auto sipmSD = static_cast<OpticalSiPM_SD*>(sdManager->FindSensitiveDetector("SiPM_SD", false));
+    if (!sipmSD) {
+        sipmSD = new OpticalSiPM_SD("SiPM_SD");
+        sdManager->AddNewDetector(sipmSD);
+    }
+    SetSensitiveDetector("SiPM", sipmSD);
+
+    // Modelo óptico rápido (solo actúa con /optics/lightmap/mode fast).
+    // La región conserva su G4FastSimulationManager (uno por hilo).
+    auto scintRegion = G4RegionStore::GetInstance()->GetRegion("ScintRegion");
+    if (scintRegion && !scintRegion->GetFastSimulationManager())
+        new OpticalFastModel("LightMapModel", scintRegion, sipmSD);
+
+    // Variance reduction: en 50 nm de grafeno casi ningún neutrón térmico
+    // interacciona (~4e-4). El operador multiplica la sección eficaz de
+    // captura del primario en el volumen (la 10B(n,a) domina a energía
+    // térmica); cada evento sigue una sola historia y su peso pasa a
+    // los secundarios y de ahí a la columna Weight de los ntuples.
+    if (fBiasedCapture) {
+        static G4ThreadLocal CaptureBiasingOperator* captureBiasing = nullptr;
+        if (!captureBiasing)
+            captureBiasing = new CaptureBiasingOperator(this);
+
+        auto logicGraph = G4LogicalVolumeStore::GetInstance()->GetVolume("graphene", false);
+        if (logicGraph)
+            captureBiasing->AttachTo(logicGraph);
+    }
 }
@@ -0,0 +1,517 @@
+#include "EventAction.hh"
+#include "RunAction.hh"
+#include "OutputConfig.hh"
+#include "SiPMConfig.hh"
+#include "PhaseSpace.hh"
+#include "ScintHit.hh"
+#include "OpticalGenHit.hh"
+#include "SiPMHit.hh"
+#include "DetectorConstruction.hh"
+#include "EventTriage.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4AnalysisManager.hh"
+#include "G4SystemOfUnits.hh"
+#ifdef SCINT_SUBEVENT
+#include "G4AutoLock.hh"
+#endif
+
+#include <algorithm>
+#include <numeric>
+#ifdef SCINT_SUBEVENT
+#include <limits>
+#include <map>
+#include <set>
+#include <utility>
+#endif
+
+namespace {
+
+template <typename T>
+T* GetCollection(const G4Event* event, G4int hcID)
+{
+    auto hce = event->GetHCofThisEvent();
+    return (hce && hcID >= 0) ? static_cast<T*>(hce->GetHC(hcID)) : nullptr;
+}
+
+#ifdef SCINT_SUBEVENT
+// Llegadas de los sub-eventos pendientes de pasar a su evento padre.
+// Datos planos: los SiPMHit usan el G4Allocator del hilo que los crea
+// y la colección del padre se libera en el hilo que lo procesa.
+struct SubEventHit
+{
+    G4double time;
+    G4double energy;
+    G4ThreeVector pos;
+    G4double weight;
+    G4int channel;
+};
+
+// Clave (run, evento): la dirección del G4Event padre puede
+// reutilizarse para otro evento en cuanto se libera
+using EventKey = std::pair<G4int, G4int>;
+
+EventKey KeyOf(const G4Event* event)
+{
+    auto run = G4RunManager::GetRunManager()->GetCurrentRun();
+    return { run ? run->GetRunID() : -1, event->GetEventID() };
+}
+
+G4Mutex subEventMutex = G4MUTEX_INITIALIZER;
+std::map<EventKey, std::vector<SubEventHit>> subEventHits;
+std::set<EventKey> closedEvents;   // padres ya escritos en el run en curso
+#endif
+
+}
+
+void EventAction::BeginOfEventAction(const G4Event* event)
+{
+    PhaseSpace::Instance()->BeginOfEvent();
+
+#ifdef SCINT_SUBEVENT
+    DiscardStaleSubEventHits(event);
+#endif
+
+    // Peso del evento: el del primer primario (con --replay, el guardado);
+    // SteppingAction lo actualiza con el peso del track 1 en cada step
+    auto vertex = event->GetPrimaryVertex();
+    fPrimaryWeight = (vertex && vertex->GetPrimary()) ? vertex->GetPrimary()->GetWeight() : 1.;
+
+    if (fSiPMHCID < 0) {
+        auto sdManager = G4SDManager::GetSDMpointer();
+        fScintHCID      = sdManager->GetCollectionID("ScintSD/ScintHits");
+        fScintTrackHCID = sdManager->GetCollectionID("ScintSD/ScintTrackHits");
+        fOpticalGenHCID = sdManager->GetCollectionID("ScintSD/OpticalGenHits");
+        fSiPMHCID       = sdManager->GetCollectionID("SiPM_SD/SiPMHits");
+        fScintChannelHCID = sdManager->GetCollectionID("ScintSD/ScintChannelHits");
+    }
+
+    // Backend de los ntuples (/output/format)
+    fOutput.Configure();
+
+    auto output = OutputConfig::Instance();
+    fWriteTracks  = output->Writes(OutputLevel::TRACK);
+    fWriteSteps   = output->Writes(OutputLevel::STEP);
+    fWritePhotons = output->Writes(OutputLevel::PHOTON);
+    fFillHistograms = output->FillsHistograms();
+
+    // El digitizador se reconfigura al empezar cada run (geometría y parámetros)
+    auto runManager = G4RunManager::GetRunManager();
+    auto detector = static_cast<const DetectorConstruction*>(runManager->GetUserDetectorConstruction());
+    fArray = detector && detector->GetNumberOfChannels() > 1;
+
+    auto sipm = SiPMConfig::Instance();
+    const G4int runID = runManager->GetCurrentRun()->GetRunID();
+    fDigitize = sipm->DigitizationEnabled();
+    if (fDigitize && runID != fDigitizerRunID) {
+        fDigitize = fDigitizer.Configure();
+        fDigitizerRunID = runID;
+    }
+
+    // Forma de onda: mismo criterio (muestreo y pulso fijos durante el run)
+    fWaveform = sipm->WaveformEnabled();
+    fStoreSamples = fWaveform && sipm->StoreWaveformSamples();
+    if (fWaveform && runID != fWaveformRunID) {
+        fWave.Configure();
+        fWaveformRunID = runID;
+    }
+}
+
+void EventAction::EndOfEventAction(const G4Event* event)
+{
+    fChannelSums.clear();
+    fChannelIndex.clear();
+
+#ifdef SCINT_SUBEVENT
+    AttachSubEventHits(event);
+#endif
+
+    WriteScintillator(event);
+    WriteSiPM(event);
+    if (fArray) WriteChannels(event);
+
+    // Bloque del espacio de fases (/phasespace/record)
+    PhaseSpace::Instance()->EndOfEvent(event->GetEventID());
+}
+
+#ifdef SCINT_SUBEVENT
+// =============================================================
+// Sub-eventos (--subevent): los fotones de centelleo de un lote se
+// siguen en otro hilo. MergeSubEvent puede llamarse desde el hilo del
+// sub-evento: solo copia sus llegadas al SiPM como datos planos, y los
+// hits se crean en EndOfEventAction, en el hilo dueño de la colección
+// del evento padre. Las demás colecciones no cambian en un sub-evento
+// (los fotones no depositan energía en el centellador).
+// =============================================================
+void EventAction::MergeSubEvent(G4Event* masterEvent, const G4Event* subEvent)
+{
+    const G4int hcID = G4SDManager::GetSDMpointer()->GetCollectionID("SiPM_SD/SiPMHits");
+    auto source = GetCollection<SiPMHitsCollection>(subEvent, hcID);
+    if (!source || source->entries() == 0) return;
+
+    const EventKey key = KeyOf(masterEvent);
+
+    G4AutoLock lock(&subEventMutex);
+    if (closedEvents.count(key)) {
+        G4cerr << "EventAction: " << source->entries() << " llegadas al SiPM de un sub-evento del evento "
+               << key.second << " (run " << key.first << ") después de escribirlo; se pierden" << G4endl;
+        return;
+    }
+    auto& pending = subEventHits[key];
+    pending.reserve(pending.size() + source->entries());
+    for (std::size_t i = 0; i < source->entries(); ++i) {
+        const SiPMHit* hit = (*source)[i];
+        pending.push_back({ hit->GetTime(), hit->GetEnergy(), hit->GetPosition(),
+                            hit->GetWeight(), hit->GetChannel() });
+    }
+}
+
+void EventAction::AttachSubEventHits(const G4Event* event)
+{
+    const EventKey key = KeyOf(event);
+
+    std::vector<SubEventHit> pending;
+    {
+        G4AutoLock lock(&subEventMutex);
+        closedEvents.insert(key);
+        auto it = subEventHits.find(key);
+        if (it == subEventHits.end()) return;
+        pending.swap(it->second);
+        subEventHits.erase(it);
+    }
+
+    auto target = GetCollection<SiPMHitsCollection>(event, fSiPMHCID);
+    if (!target) return;
+    for (const auto& hit : pending)
+        target->insert(new SiPMHit(hit.time, hit.energy, hit.pos, hit.weight, hit.channel));
+}
+
+// Restos de runs anteriores (o de un evento abortado con el mismo
+// número): no pertenecen al evento que empieza. Las claves están
+// ordenadas por run, así que los runs anteriores son un prefijo
+void EventAction::DiscardStaleSubEventHits(const G4Event* event)
+{
+    const EventKey key = KeyOf(event);
+    const EventKey runStart{ key.first, std::numeric_limits<G4int>::min() };
+
+    G4AutoLock lock(&subEventMutex);
+    std::size_t stale = 0;
+    const auto firstCurrent = subEventHits.lower_bound(runStart);
+    for (auto it = subEventHits.begin(); it != firstCurrent; ++it)
+        stale += it->second.size();
+    subEventHits.erase(subEventHits.begin(), firstCurrent);
+
+    auto it = subEventHits.find(key);
+    if (it != subEventHits.end()) {
+        stale += it->second.size();
+        subEventHits.erase(it);
+    }
+
+    closedEvents.erase(closedEvents.begin(), closedEvents.lower_bound(runStart));
+    closedEvents.erase(key);
+
+    if (stale > 0)
+        G4cerr << "EventAction: se descartan " << stale
+               << " llegadas al SiPM de sub-eventos de eventos anteriores" << G4endl;
+}
+#endif
+
+// =============================================================
+// Centellador: ScintData, OpticalGen, ScintTrack y ScintEvent
+// =============================================================
+void EventAction::WriteScintillator(const G4Event* event)
+{
+    auto analysis = &fOutput;
+    const G4int eventID = event->GetEventID();
+
+    // ------------------------------------------------------------
+    // NTUPLE 0: un registro por step con Edep (nivel step)
+    // ------------------------------------------------------------
+    auto stepHits = GetCollection<ScintHitsCollection>(event, fScintHCID);
+    if (stepHits && fWriteSteps) {
+        for (std::size_t i = 0; i < stepHits->entries(); ++i) {
+            const ScintHit* hit = (*stepHits)[i];
+            const G4ThreeVector& pos = hit->GetPosition();
+
+            analysis->FillNtupleIColumn(NtupleId::ScintData, 0, eventID);
+            analysis->FillNtupleIColumn(NtupleId::ScintData, 1, hit->GetTrackID());
+            analysis->FillNtupleIColumn(NtupleId::ScintData, 2, hit->GetPDG());
+            analysis->FillNtupleDColumn(NtupleId::ScintData, 3, hit->GetKineticEnergy() / MeV);
+            analysis->FillNtupleDColumn(NtupleId::ScintData, 4, hit->GetEdep() / MeV);
+            analysis->FillNtupleDColumn(NtupleId::ScintData, 5, pos.x() / mm);
+            analysis->FillNtupleDColumn(NtupleId::ScintData, 6, pos.y() / mm);
+            analysis->FillNtupleDColumn(NtupleId::ScintData, 7, pos.z() / mm);
+            analysis->FillNtupleIColumn(NtupleId::ScintData, 8, hit->GetCreatorID());
+            analysis->FillNtupleDColumn(NtupleId::ScintData, 9, hit->GetWeight());
+            analysis->AddNtupleRow(NtupleId::ScintData);
+        }
+    }
+
+    // ------------------------------------------------------------
+    // NTUPLE 4: fotones ópticos generados (nivel photon)
+    // ------------------------------------------------------------
+    auto genHits = GetCollection<OpticalGenHitsCollection>(event, fOpticalGenHCID);
+    if (genHits && fWritePhotons) {
+        for (std::size_t i = 0; i < genHits->entries(); ++i) {
+            const OpticalGenHit* hit = (*genHits)[i];
+            const G4ThreeVector& pos = hit->GetPosition();
+
+            analysis->FillNtupleIColumn(NtupleId::OpticalGen, 0, eventID);
+            analysis->FillNtupleIColumn(NtupleId::OpticalGen, 1, hit->GetParentTrackID());
+            analysis->FillNtupleIColumn(NtupleId::OpticalGen, 2, hit->GetPhotonTrackID());
+            analysis->FillNtupleIColumn(NtupleId::OpticalGen, 3, hit->GetProcessID());
+            analysis->FillNtupleDColumn(NtupleId::OpticalGen, 4, hit->GetEnergy() / eV);
+            analysis->FillNtupleDColumn(NtupleId::OpticalGen, 5, pos.x() / mm);
+            analysis->FillNtupleDColumn(NtupleId::OpticalGen, 6, pos.y() / mm);
+            analysis->FillNtupleDColumn(NtupleId::OpticalGen, 7, pos.z() / mm);
+            analysis->FillNtupleDColumn(NtupleId::OpticalGen, 8, hit->GetTime() / ns);
+            analysis->FillNtupleIColumn(NtupleId::OpticalGen, 9, hit->GetParentPDG());
+            analysis->FillNtupleDColumn(NtupleId::OpticalGen, 10, hit->GetWeight());
+            analysis->AddNtupleRow(NtupleId::OpticalGen);
+        }
+    }
+
+    // ------------------------------------------------------------
+    // NTUPLE 5 (nivel track) y NTUPLE 1: energía por track y total
+    // ------------------------------------------------------------
+    G4double totalE = 0.;
+    auto trackHits = GetCollection<ScintTrackHitsCollection>(event, fScintTrackHCID);
+    if (trackHits) {
+        for (std::size_t i = 0; i < trackHits->entries(); ++i) {
+            const ScintTrackHit* hit = (*trackHits)[i];
+            totalE += hit->GetEdep();
+
+            if (!fWriteTracks)
+                continue;
+
+            analysis->FillNtupleIColumn(NtupleId::ScintTrack, 0, eventID);
+            analysis->FillNtupleIColumn(NtupleId::ScintTrack, 1, hit->GetTrackID());
+            analysis->FillNtupleIColumn(NtupleId::ScintTrack, 2, hit->GetPDG());
+            analysis->FillNtupleDColumn(NtupleId::ScintTrack, 3, hit->GetEdep() / MeV);
+            analysis->FillNtupleDColumn(NtupleId::ScintTrack, 4, hit->GetWeight());
+            analysis->AddNtupleRow(NtupleId::ScintTrack);
+        }
+    }
+
+    analysis->FillNtupleIColumn(NtupleId::ScintEvent, 0, eventID);
+    analysis->FillNtupleDColumn(NtupleId::ScintEvent, 1, totalE / MeV);
+    analysis->FillNtupleDColumn(NtupleId::ScintEvent, 2, fPrimaryWeight);
+    analysis->AddNtupleRow(NtupleId::ScintEvent);
+
+    // Espectro de energía (modo histograma)
+    if (fFillHistograms)
+        G4AnalysisManager::Instance()->FillH1(HistoId::TotalEdep, totalE, fPrimaryWeight);
+}
+
+// =============================================================
+// SiPM: SiPMData, SiPMSummary, SiPMDigi y SiPMWave
+// =============================================================
+void EventAction::WriteSiPM(const G4Event* event)
+{
+    auto analysis = &fOutput;
+    const G4int eventID = event->GetEventID();
+
+    auto histograms = fFillHistograms ? G4AnalysisManager::Instance() : nullptr;
+
+    auto hits = GetCollection<SiPMHitsCollection>(event, fSiPMHCID);
+    const std::size_t nHits = hits ? hits->entries() : 0;
+
+    const G4bool keepHits = fDigitize || fWaveform;
+    if (keepHits) {
+        fHitTime.clear();
+        fHitX.clear();
+        fHitY.clear();
+        fHitChannel.clear();
+    }
+
+    for (std::size_t i = 0; i < nHits; ++i) {
+        const SiPMHit* hit = (*hits)[i];
+        const G4ThreeVector& pos = hit->GetPosition();
+
+        if (keepHits) {
+            fHitTime.push_back(hit->GetTime());
+            fHitX.push_back(pos.x());
+            fHitY.push_back(pos.y());
+            fHitChannel.push_back(hit->GetChannel());
+        }
+
+        if (fArray) {
+            ChannelSum& sum = GetChannelSum(hit->GetChannel());
+            sum.nPhotons++;
+        }
+
+        // Modo histograma: un incremento de bin por fotón (unidades en CreateH1/H2)
+        if (histograms) {
+            histograms->FillH1(HistoId::PhotonTime, hit->GetTime(), hit->GetWeight());
+            histograms->FillH2(HistoId::SiPMHitMap, pos.x(), pos.y(), hit->GetWeight());
+        }
+
+        // Datos de cada fotón detectado (solo en nivel photon)
+        if (!fWritePhotons)
+            continue;
+
+        analysis->FillNtupleDColumn(NtupleId::SiPMData, 0, hit->GetTime() / ns);
+        analysis->FillNtupleDColumn(NtupleId::SiPMData, 1, hit->GetEnergy() / eV);
+        analysis->FillNtupleDColumn(NtupleId::SiPMData, 2, pos.x() / mm);
+        analysis->FillNtupleDColumn(NtupleId::SiPMData, 3, pos.y() / mm);
+        analysis->FillNtupleDColumn(NtupleId::SiPMData, 4, pos.z() / mm);
+        analysis->FillNtupleDColumn(NtupleId::SiPMData, 5, hit->GetWeight());
+        analysis->AddNtupleRow(NtupleId::SiPMData);
+    }
+
+    analysis->FillNtupleIColumn(NtupleId::SiPMSummary, 0, eventID);                     // Column 0: EventID
+    analysis->FillNtupleIColumn(NtupleId::SiPMSummary, 1, static_cast<G4int>(nHits));   // Column 1: nPhotons
+    const G4double weight = fPrimaryWeight;
+    analysis->FillNtupleDColumn(NtupleId::SiPMSummary, 2, weight);
+    const auto triage = EventTriage::Local();
+    analysis->FillNtupleIColumn(NtupleId::SiPMSummary, 3,
+                                static_cast<G4int>(triage->active ? triage->fate : TriageFate::TRACKED));
+    analysis->AddNtupleRow(NtupleId::SiPMSummary);
+
+    if (histograms)
+        histograms->FillH1(HistoId::NPhotons, static_cast<G4double>(nHits), weight);
+
+    if (fDigitize) {
+        // Microceldas, crosstalk, afterpulses y cuentas oscuras en la ventana
+        fDigitizer.BeginEvent();
+        const SiPMDigi digi = fArray ? DigitizeChannels()
+                                     : fDigitizer.Digitize(fHitTime, fHitX, fHitY);
+
+        analysis->FillNtupleIColumn(NtupleId::SiPMDigi, 0, eventID);
+        analysis->FillNtupleIColumn(NtupleId::SiPMDigi, 1, digi.nFiredCells);
+        analysis->FillNtupleDColumn(NtupleId::SiPMDigi, 2, digi.charge);
+        analysis->FillNtupleIColumn(NtupleId::SiPMDigi, 3, digi.nPhotons);
+        analysis->FillNtupleIColumn(NtupleId::SiPMDigi, 4, digi.nDark);
+        analysis->FillNtupleIColumn(NtupleId::SiPMDigi, 5, digi.nCrosstalk);
+        analysis->FillNtupleIColumn(NtupleId::SiPMDigi, 6, digi.nAfterpulse);
+        analysis->FillNtupleDColumn(NtupleId::SiPMDigi, 7, weight);
+        analysis->AddNtupleRow(NtupleId::SiPMDigi);
+    }
+
+    if (fWaveform)
+        WriteWaveform(eventID, weight);
+}
+
+// =============================================================
+// Forma de onda: SiPMWave y, con storeSamples, SiPMWaveSamples
+// =============================================================
+void EventAction::WriteWaveform(G4int eventID, G4double weight)
+{
+    auto analysis = &fOutput;
+
+    // Pulsos: avalanchas del digitizador (con recuperación, crosstalk,
+    // afterpulses y cuentas oscuras) o 1 p.e. por fotón detectado
+    SiPMWaveFeatures features;
+    if (fDigitize) {
+        features = fWave.Process(fDigitizer.GetPulseTimes(), fDigitizer.GetPulseAmplitudes());
+    }
+    else {
+        fUnitAmplitude.assign(fHitTime.size(), 1.);
+        features = fWave.Process(fHitTime, fUnitAmplitude);
+    }
+
+    analysis->FillNtupleIColumn(NtupleId::SiPMWave, 0, eventID);
+    analysis->FillNtupleDColumn(NtupleId::SiPMWave, 1, features.baseline);
+    analysis->FillNtupleDColumn(NtupleId::SiPMWave, 2, features.amplitude);
+    analysis->FillNtupleDColumn(NtupleId::SiPMWave, 3, features.cfdTime / ns);
+    analysis->FillNtupleDColumn(NtupleId::SiPMWave, 4, features.charge);
+    analysis->FillNtupleIColumn(NtupleId::SiPMWave, 5, features.pileUp ? 1 : 0);
+    analysis->FillNtupleIColumn(NtupleId::SiPMWave, 6, features.saturated ? 1 : 0);
+    analysis->FillNtupleDColumn(NtupleId::SiPMWave, 7, weight);
+    analysis->AddNtupleRow(NtupleId::SiPMWave);
+
+    // Muestras crudas: una fila por muestra, mucho más volumen que las
+    // features; solo para validar el procesado
+    if (!fStoreSamples) return;
+
+    const auto& samples = fWave.GetSamples();
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        analysis->FillNtupleIColumn(NtupleId::SiPMWaveSamples, 0, eventID);
+        analysis->FillNtupleIColumn(NtupleId::SiPMWaveSamples, 1, static_cast<G4int>(i));
+        analysis->FillNtupleIColumn(NtupleId::SiPMWaveSamples, 2, samples[i]);
+        analysis->AddNtupleRow(NtupleId::SiPMWaveSamples);
+    }
+}
+
+// =============================================================
+// Matriz: digitización canal a canal (la malla de un SiPM se reutiliza)
+// =============================================================
+SiPMDigi EventAction::DigitizeChannels()
+{
+    const std::size_t nHits = fHitTime.size();
+    fOrder.resize(nHits);
+    std::iota(fOrder.begin(), fOrder.end(), std::size_t(0));
+    std::sort(fOrder.begin(), fOrder.end(),
+              [this](std::size_t a, std::size_t b) { return fHitChannel[a] < fHitChannel[b]; });
+
+    // Solo los canales con fotones: las cuentas oscuras de los canales
+    // sin señal no se simulan
+    SiPMDigi digi;
+    for (std::size_t begin = 0; begin < nHits; ) {
+        const G4int channel = fHitChannel[fOrder[begin]];
+
+        fChannelTime.clear();
+        fChannelX.clear();
+        fChannelY.clear();
+        std::size_t end = begin;
+        for (; end < nHits && fHitChannel[fOrder[end]] == channel; ++end) {
+            fChannelTime.push_back(fHitTime[fOrder[end]]);
+            fChannelX.push_back(fHitX[fOrder[end]]);
+            fChannelY.push_back(fHitY[fOrder[end]]);
+        }
+
+        const SiPMDigi channelDigi = fDigitizer.Digitize(fChannelTime, fChannelX, fChannelY, channel);
+        GetChannelSum(channel).charge = channelDigi.charge;
+        digi += channelDigi;
+        begin = end;
+    }
+    return digi;
+}
+
+// =============================================================
+// Matriz: ChannelSum, una fila por canal con Edep o fotones
+// =============================================================
+void EventAction::WriteChannels(const G4Event* event)
+{
+    auto analysis = &fOutput;
+    const G4int eventID = event->GetEventID();
+
+    auto channelHits = GetCollection<ScintChannelHitsCollection>(event, fScintChannelHCID);
+    if (channelHits) {
+        for (std::size_t i = 0; i < channelHits->entries(); ++i) {
+            const ScintChannelHit* hit = (*channelHits)[i];
+            ChannelSum& sum = GetChannelSum(hit->GetChannel());
+            sum.edep += hit->GetEdep();
+        }
+    }
+
+    std::sort(fChannelSums.begin(), fChannelSums.end(),
+              [](const ChannelSum& a, const ChannelSum& b) { return a.channel < b.channel; });
+
+    for (const auto& sum : fChannelSums) {
+        analysis->FillNtupleIColumn(NtupleId::ChannelSum, 0, eventID);
+        analysis->FillNtupleIColumn(NtupleId::ChannelSum, 1, sum.channel);
+        analysis->FillNtupleDColumn(NtupleId::ChannelSum, 2, sum.edep / MeV);
+        analysis->FillNtupleIColumn(NtupleId::ChannelSum, 3, sum.nPhotons);
+        analysis->FillNtupleDColumn(NtupleId::ChannelSum, 4, sum.charge);
+        analysis->FillNtupleDColumn(NtupleId::ChannelSum, 5, fPrimaryWeight);
+        analysis->AddNtupleRow(NtupleId::ChannelSum);
+    }
+}
+
+EventAction::ChannelSum& EventAction::GetChannelSum(G4int channel)
+{
+    auto it = fChannelIndex.find(channel);
+    if (it == fChannelIndex.end()) {
+        fChannelSums.push_back(ChannelSum{});
+        fChannelSums.back().channel = channel;
+        it = fChannelIndex.emplace(channel, fChannelSums.size() - 1).first;
+    }
+    return fChannelSums[it->second];
+}
@@ -0,0 +1,220 @@
+#include "EventTriage.hh"
+#include "OpticsConfig.hh"
+#include "ScintHit.hh"
+#include "MasterCommand.hh"
+
+#include "G4AutoLock.hh"
+#include "G4GenericMessenger.hh"
+#include "G4ApplicationState.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Navigator.hh"
+#include "G4Neutron.hh"
+#include "G4SDManager.hh"
+#include "G4StackManager.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+namespace {
+G4ThreadLocal TriageTable* fLocalTable = nullptr;
+}
+
+// =============================================================
+// Estado por hilo
+// =============================================================
+void TriageTable::Configure()
+{
+    events = aborted = opticsSkipped = photonsSkipped = 0;
+
+    auto triage = EventTriage::Instance();
+    abortOnEscape = triage->AbortOnEscape();
+    minOpticsEdep = triage->GetMinOpticsEdep();
+
+    // La calibración del mapa de luz necesita todos los fotones
+    if (OpticsConfig::Instance()->GetLightMapMode() == LightMapMode::CALIBRATE)
+        minOpticsEdep = 0.;
+
+    active = abortOnEscape || minOpticsEdep > 0.;
+    if (!active) return;
+
+    // La geometría se reconstruye con /det/...: la región se calcula en
+    // cada run. Los hijos del mundo no están rotados.
+    const G4double inf = std::numeric_limits<G4double>::max();
+    regionMin.set(inf, inf, inf);
+    regionMax.set(-inf, -inf, -inf);
+
+    auto world = G4TransportationManager::GetTransportationManager()
+                     ->GetNavigatorForTracking()->GetWorldVolume();
+    auto logicWorld = world->GetLogicalVolume();
+    for (std::size_t i = 0; i < logicWorld->GetNoDaughters(); ++i) {
+        const G4VPhysicalVolume* daughter = logicWorld->GetDaughter(i);
+        G4ThreeVector low, high;
+        daughter->GetLogicalVolume()->GetSolid()->BoundingLimits(low, high);
+        low += daughter->GetTranslation();
+        high += daughter->GetTranslation();
+        for (G4int axis = 0; axis < 3; ++axis) {
+            regionMin[axis] = std::min(regionMin[axis], low[axis]);
+            regionMax[axis] = std::max(regionMax[axis], high[axis]);
+        }
+    }
+}
+
+void TriageTable::BeginEvent()
+{
+    fate = TriageFate::TRACKED;
+    released = false;
+    events++;
+}
+
+void TriageTable::Apply(const G4Step* step)
+{
+    G4Track* track = step->GetTrack();
+    if (track->GetParentID() != 0 || track->GetTrackStatus() != fAlive ||
+        track->GetDefinition() != G4Neutron::Definition())
+        return;
+
+    // Vivo: todavía no se ha capturado. Sale si, en algún eje, está
+    // fuera de la región y se aleja de ella (el haz llega desde fuera)
+    const G4StepPoint* post = step->GetPostStepPoint();
+    const G4ThreeVector& position = post->GetPosition();
+    const G4ThreeVector& direction = post->GetMomentumDirection();
+
+    G4bool leaving = false;
+    for (G4int axis = 0; axis < 3 && !leaving; ++axis) {
+        leaving = (position[axis] < regionMin[axis] && direction[axis] < 0.) ||
+                  (position[axis] > regionMax[axis] && direction[axis] > 0.);
+    }
+    if (!leaving) return;
+
+    track->SetTrackStatus(fStopAndKill);
+
+    // Sin tracks pendientes el evento termina aquí; si una dispersión
+    // dejó secundarios, se siguen con normalidad
+    if (G4EventManager::GetEventManager()->GetStackManager()->GetNTotalTrack() == 0) {
+        fate = TriageFate::ABORTED;
+        aborted++;
+    }
+}
+
+G4bool TriageTable::ReleaseOptics(G4int nDeferred)
+{
+    released = true;
+    if (nDeferred == 0 || fate == TriageFate::ABORTED) return true;
+
+    // Los SDs solo existen en los hilos que procesan eventos
+    if (channelHCID < 0)
+        channelHCID = G4SDManager::GetSDMpointer()->GetCollectionID("ScintSD/ScintChannelHits");
+
+    // Todo lo que no es fotón óptico ya se ha seguido: el Edep es el final
+    G4double edep = 0.;
+    auto event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+    auto hce = event ? event->GetHCofThisEvent() : nullptr;
+    auto channels = hce ? static_cast<ScintChannelHitsCollection*>(hce->GetHC(channelHCID)) : nullptr;
+    for (std::size_t i = 0; channels && i < channels->entries(); ++i)
+        edep += (*channels)[i]->GetEdep();
+
+    if (edep >= minOpticsEdep) return true;
+
+    fate = TriageFate::OPTICS_SKIPPED;
+    opticsSkipped++;
+    photonsSkipped += nDeferred;
+    return false;
+}
+
+// =============================================================
+// Singleton y ciclo de vida por run
+// =============================================================
+EventTriage* EventTriage::Instance()
+{
+    // Debe crearse primero en el maestro para registrar sus comandos
+    static EventTriage* instance = new EventTriage();
+    return instance;
+}
+
+TriageTable* EventTriage::Local()
+{
+    if (!fLocalTable) fLocalTable = new TriageTable();
+    return fLocalTable;
+}
+
+EventTriage::EventTriage()
+{
+    fMessenger = new G4GenericMessenger(this, "/triage/",
+                                        "Triaje de eventos sin captura o sin luz");
+
+    auto& abortCmd = fMessenger->DeclareProperty("abortOnEscape", fAbortOnEscape,
+        "Termina el neutrón primario al salir de la región del detector sin capturarse; "
+        "sin otros tracks pendientes el evento acaba ahí.");
+    abortCmd.SetParameterName("abort", true);
+    abortCmd.SetDefaultValue("true");
+    MasterOnly(abortCmd);
+
+    auto& edepCmd = fMessenger->DeclarePropertyWithUnit("minOpticsEdep", "keV", fMinOpticsEdep,
+        "Difiere los fotones ópticos hasta conocer el Edep del evento en el centellador y no "
+        "los sigue si es menor (0: sin diferir). Se ignora en /optics/lightmap/mode calibrate.");
+    edepCmd.SetParameterName("edep", false);
+    edepCmd.SetRange("edep>=0.");
+    MasterOnly(edepCmd);
+}
+
+void EventTriage::BeginOfRun(G4bool isMaster)
+{
+    auto triage = Instance();
+    Local()->Configure();
+
+    // El maestro empieza su run antes que los workers
+    if (isMaster) {
+        triage->fTotals = TriageTable();
+        if (triage->fMinOpticsEdep > 0. &&
+            OpticsConfig::Instance()->GetLightMapMode() == LightMapMode::CALIBRATE)
+            G4cout << "/triage/minOpticsEdep ignorado durante la calibración del mapa de luz" << G4endl;
+    }
+}
+
+void EventTriage::EndOfRun(G4bool isMaster)
+{
+    auto local = Local();
+    if (!local->active) return;
+
+    // Los workers terminan su run antes que el maestro
+    auto triage = Instance();
+    triage->Merge(*local);
+
+    if (isMaster) triage->Report();
+}
+
+void EventTriage::Merge(const TriageTable& table)
+{
+    G4AutoLock lock(&fMergeMutex);
+    fTotals.events         += table.events;
+    fTotals.aborted        += table.aborted;
+    fTotals.opticsSkipped  += table.opticsSkipped;
+    fTotals.photonsSkipped += table.photonsSkipped;
+}
+
+void EventTriage::Report() const
+{
+    const G4long events = fTotals.events;
+    auto percent = [events](G4long count) { return events ? 100. * count / events : 0.; };
+
+    char line[128];
+    G4cout << "\n=============== TRIAJE DE EVENTOS ===============\n"
+           << "Eventos: " << events << G4endl;
+    std::snprintf(line, sizeof(line), "  %-28s %12ld %7.2f%%\n",
+                  "abortados (neutrón fuera)", fTotals.aborted, percent(fTotals.aborted));
+    G4cout << line;
+    std::snprintf(line, sizeof(line), "  %-28s %12ld %7.2f%%\n",
+                  "óptica omitida (Edep bajo)", fTotals.opticsSkipped, percent(fTotals.opticsSkipped));
+    G4cout << line;
+    G4cout << "  Fotones ópticos no seguidos: " << fTotals.photonsSkipped << "\n"
+           << "=================================================" << G4endl;
+}
@@ -0,0 +1,316 @@
+#include "LightCollectionMap.hh"
+#include "OpticsConfig.hh"
+#include "OutputConfig.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+G4ThreadLocal LightCollectionMap* fLocalMap = nullptr;
+
+constexpr char kMagic[8] = { 'L', 'C', 'M', 'A', 'P', '0', '1', '\0' };
+}
+
+LightCollectionMap* LightCollectionMap::Shared()
+{
+    static LightCollectionMap* instance = new LightCollectionMap();
+    return instance;
+}
+
+LightCollectionMap* LightCollectionMap::Local()
+{
+    if (!fLocalMap) fLocalMap = new LightCollectionMap();
+    return fLocalMap;
+}
+
+// =============================================================
+// Ciclo de vida por run
+// =============================================================
+void LightCollectionMap::BeginOfRun(G4bool isMaster)
+{
+    auto optics = OpticsConfig::Instance();
+    auto mode = optics->GetLightMapMode();
+
+    // Sin mapa, salvo que /optics/photon/minDetectionProbability lo lea
+    const G4bool policyMap = mode == LightMapMode::OFF && optics->GetMinDetectionProbability() > 0.;
+    if (mode == LightMapMode::OFF && !policyMap) return;
+
+    const G4int nx = optics->GetVoxelsX();
+    const G4int ny = optics->GetVoxelsY();
+    const G4int nz = optics->GetVoxelsZ();
+    const G4int nt = optics->GetTimeBins();
+    const G4double tmax = optics->GetMaxTime();
+
+    if (mode == LightMapMode::CALIBRATE) {
+        Local()->ConfigureFromGeometry(nx, ny, nz, nt, tmax);
+        if (isMaster) Shared()->ConfigureFromGeometry(nx, ny, nz, nt, tmax);
+        return;
+    }
+
+    // FAST (o lectura para la política de fotones): solo el maestro
+    // carga, antes de que empiecen los workers
+    if (!isMaster) return;
+
+    if (!policyMap && !optics->HasFastSimPhysics()) {
+        G4cerr << "LightCollectionMap: modo fast sin G4FastSimulationPhysics "
+               << "(ejecutar con --fastsim); se usará tracking completo." << G4endl;
+    }
+
+    auto shared = Shared();
+    shared->ConfigureFromGeometry(nx, ny, nz, nt, tmax);
+    G4String fileName = shared->GetFileName(optics->GetMapDirectory());
+
+    if (shared->Load(fileName)) {
+        G4cout << "Mapa de colección de luz cargado: " << fileName << G4endl;
+    }
+    else {
+        G4cerr << "LightCollectionMap: no hay mapa válido en " << fileName
+               << " (correr antes con /optics/lightmap/mode calibrate); "
+               << (policyMap ? "minDetectionProbability queda desactivado."
+                             : "se usará tracking completo.") << G4endl;
+    }
+}
+
+void LightCollectionMap::EndOfRun(G4bool isMaster)
+{
+    auto optics = OpticsConfig::Instance();
+    if (optics->GetLightMapMode() != LightMapMode::CALIBRATE) return;
+
+    // Los workers terminan su run antes que el maestro
+    Shared()->Merge(*Local());
+
+    if (!isMaster) return;
+
+    auto shared = Shared();
+    shared->Finalize();
+
+    // Con --workers/--checkpoint cada proceso o bloque guarda su parte
+    // (lightmap_<clave>_w<i>.bin); el modo fast solo carga el nombre sin sufijo
+    const G4String fileName =
+        OutputConfig::Instance()->AddFileSuffix(shared->GetFileName(optics->GetMapDirectory()));
+    if (shared->Save(fileName))
+        G4cout << "Mapa de colección de luz guardado: " << fileName << G4endl;
+}
+
+// =============================================================
+// Geometría
+// =============================================================
+G4bool LightCollectionMap::ConfigureFromGeometry(G4int nx, G4int ny, G4int nz,
+                                                 G4int nTimeBins, G4double maxTime)
+{
+    fReady = false;
+
+    auto store = G4PhysicalVolumeStore::GetInstance();
+    auto scint = store->GetVolume("Scintillator", false);
+    auto sipm  = store->GetVolume("SiPM", false);
+    auto box = scint ? dynamic_cast<G4Box*>(scint->GetLogicalVolume()->GetSolid()) : nullptr;
+    auto sipmBox = sipm ? dynamic_cast<G4Box*>(sipm->GetLogicalVolume()->GetSolid()) : nullptr;
+
+    if (!box || !sipmBox) {
+        G4cerr << "LightCollectionMap: no se encontró el volumen Scintillator/SiPM" << G4endl;
+        return false;
+    }
+
+    // El mapa está en coordenadas globales de una sola pieza
+    if (store->GetVolume("ArrayCell", false)) {
+        G4cerr << "LightCollectionMap: el mapa de luz no admite la matriz (/det/array)" << G4endl;
+        fNx = 0;
+        return false;
+    }
+
+    fCenter = scint->GetTranslation();
+    fHalfSize = G4ThreeVector(box->GetXHalfLength(),
+                              box->GetYHalfLength(),
+                              box->GetZHalfLength());
+    fNx = nx;
+    fNy = ny;
+    fNz = nz;
+    fNt = nTimeBins;
+    fMaxTime = maxTime;
+
+    // La clave identifica la combinación geometría + malla del mapa
+    std::ostringstream key;
+    key << scint->GetLogicalVolume()->GetMaterial()->GetName()
+        << "_" << 2*fHalfSize.x()/mm << "x" << 2*fHalfSize.y()/mm << "x" << 2*fHalfSize.z()/mm
+        << "mm_SiPM" << 2*sipmBox->GetXHalfLength()/mm << "x" << 2*sipmBox->GetYHalfLength()/mm
+        << "mm_" << fNx << "x" << fNy << "x" << fNz
+        << "_t" << fNt << "x" << fMaxTime/ns << "ns";
+    fKey = key.str();
+
+    const std::size_t nVoxels = static_cast<std::size_t>(fNx) * fNy * fNz;
+    fBorn.assign(nVoxels, 0.);
+    fArrived.assign(nVoxels, 0.);
+    fTime.assign(nVoxels * fNt, 0.);
+    fEfficiency.clear();
+    fTimeCDF.clear();
+
+    return true;
+}
+
+G4int LightCollectionMap::VoxelIndex(const G4ThreeVector& pos) const
+{
+    if (fNx == 0) return -1;
+
+    const G4ThreeVector local = pos - fCenter;
+
+    const G4int ix = static_cast<G4int>((local.x() + fHalfSize.x()) / (2*fHalfSize.x()) * fNx);
+    const G4int iy = static_cast<G4int>((local.y() + fHalfSize.y()) / (2*fHalfSize.y()) * fNy);
+    const G4int iz = static_cast<G4int>((local.z() + fHalfSize.z()) / (2*fHalfSize.z()) * fNz);
+
+    if (ix < 0 || ix >= fNx || iy < 0 || iy >= fNy || iz < 0 || iz >= fNz)
+        return -1;
+
+    return (iz * fNy + iy) * fNx + ix;
+}
+
+G4ThreeVector LightCollectionMap::ProjectToExitFace(const G4ThreeVector& pos) const
+{
+    // El SiPM está acoplado a la cara +Z del centellador
+    return G4ThreeVector(pos.x(), pos.y(), fCenter.z() + fHalfSize.z());
+}
+
+// =============================================================
+// Calibración
+// =============================================================
+void LightCollectionMap::AddBorn(const G4ThreeVector& vertex)
+{
+    const G4int voxel = VoxelIndex(vertex);
+    if (voxel >= 0) fBorn[voxel] += 1.;
+}
+
+void LightCollectionMap::AddArrival(const G4ThreeVector& vertex, G4double transitTime)
+{
+    const G4int voxel = VoxelIndex(vertex);
+    if (voxel < 0) return;
+
+    G4int bin = static_cast<G4int>(transitTime / fMaxTime * fNt);
+    bin = std::min(std::max(bin, 0), fNt - 1);
+
+    fArrived[voxel] += 1.;
+    fTime[static_cast<std::size_t>(voxel) * fNt + bin] += 1.;
+}
+
+void LightCollectionMap::Merge(const LightCollectionMap& other)
+{
+    G4AutoLock lock(&fMergeMutex);
+
+    if (other.fKey != fKey || other.fBorn.size() != fBorn.size()) return;
+
+    for (std::size_t i = 0; i < fBorn.size(); ++i) {
+        fBorn[i]    += other.fBorn[i];
+        fArrived[i] += other.fArrived[i];
+    }
+    for (std::size_t i = 0; i < fTime.size(); ++i)
+        fTime[i] += other.fTime[i];
+}
+
+void LightCollectionMap::Finalize()
+{
+    const std::size_t nVoxels = fBorn.size();
+    if (nVoxels == 0 || fNt == 0) return;
+
+    // Promedio de todo el volumen para vóxeles con poca estadística
+    G4double bornTotal = 0., arrivedTotal = 0.;
+    std::vector<G4double> timeTotal(fNt, 0.);
+    for (std::size_t v = 0; v < nVoxels; ++v) {
+        bornTotal += fBorn[v];
+        arrivedTotal += fArrived[v];
+        for (G4int b = 0; b < fNt; ++b)
+            timeTotal[b] += fTime[v * fNt + b];
+    }
+    const G4double meanEfficiency = bornTotal > 0. ? arrivedTotal / bornTotal : 0.;
+
+    fEfficiency.assign(nVoxels, 0.);
+    fTimeCDF.assign(nVoxels * fNt, 0.);
+
+    for (std::size_t v = 0; v < nVoxels; ++v) {
+        const G4bool enough = fBorn[v] >= kMinBornPerVoxel && fArrived[v] > 0.;
+        fEfficiency[v] = enough ? fArrived[v] / fBorn[v] : meanEfficiency;
+
+        const G4double* hist = enough ? &fTime[v * fNt] : timeTotal.data();
+        G4double sum = 0.;
+        for (G4int b = 0; b < fNt; ++b) sum += hist[b];
+
+        G4double cumulative = 0.;
+        for (G4int b = 0; b < fNt; ++b) {
+            cumulative += hist[b];
+            fTimeCDF[v * fNt + b] = sum > 0. ? cumulative / sum : G4double(b + 1) / fNt;
+        }
+    }
+
+    fReady = true;
+}
+
+// =============================================================
+// Modo rápido
+// =============================================================
+G4double LightCollectionMap::SampleTransitTime(G4int voxel) const
+{
+    const G4double* cdf = &fTimeCDF[static_cast<std::size_t>(voxel) * fNt];
+    const G4int bin = static_cast<G4int>(std::upper_bound(cdf, cdf + fNt - 1, G4UniformRand()) - cdf);
+    return (bin + G4UniformRand()) * fMaxTime / fNt;
+}
+
+// =============================================================
+// Persistencia
+// =============================================================
+G4String LightCollectionMap::GetFileName(const G4String& directory) const
+{
+    return directory + "/lightmap_" + fKey + ".bin";
+}
+
+G4bool LightCollectionMap::Save(const G4String& fileName) const
+{
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out) {
+        G4cerr << "LightCollectionMap: no se pudo escribir " << fileName << G4endl;
+        return false;
+    }
+
+    const std::uint32_t keySize = static_cast<std::uint32_t>(fKey.size());
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+    out.write(fKey.data(), keySize);
+    out.write(reinterpret_cast<const char*>(fBorn.data()),    fBorn.size()    * sizeof(G4double));
+    out.write(reinterpret_cast<const char*>(fArrived.data()), fArrived.size() * sizeof(G4double));
+    out.write(reinterpret_cast<const char*>(fTime.data()),    fTime.size()    * sizeof(G4double));
+
+    return static_cast<G4bool>(out);
+}
+
+G4bool LightCollectionMap::Load(const G4String& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in) return false;
+
+    char magic[sizeof(kMagic)];
+    std::uint32_t keySize = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
+    if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || keySize != fKey.size())
+        return false;
+
+    std::string key(keySize, '\0');
+    in.read(&key[0], keySize);
+    if (key != fKey) return false;   // otra geometría o malla
+
+    in.read(reinterpret_cast<char*>(fBorn.data()),    fBorn.size()    * sizeof(G4double));
+    in.read(reinterpret_cast<char*>(fArrived.data()), fArrived.size() * sizeof(G4double));
+    in.read(reinterpret_cast<char*>(fTime.data()),    fTime.size()    * sizeof(G4double));
+    if (!in) return false;
+
+    Finalize();
+    return fReady;
+}
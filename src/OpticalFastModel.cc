@@ -0,0 +1,45 @@
+#include "OpticalFastModel.hh"
+#include "OpticalSiPM_SD.hh"
+#include "LightCollectionMap.hh"
+#include "OpticsConfig.hh"
+
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+OpticalFastModel::OpticalFastModel(const G4String& name, G4Region* envelope,
+                                   OpticalSiPM_SD* sipmSD)
+: G4VFastSimulationModel(name, envelope),
+  fSiPM(sipmSD)
+{}
+
+G4bool OpticalFastModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+    return &particle == G4OpticalPhoton::OpticalPhotonDefinition();
+}
+
+G4bool OpticalFastModel::ModelTrigger(const G4FastTrack&)
+{
+    return OpticsConfig::Instance()->GetLightMapMode() == LightMapMode::FAST
+        && LightCollectionMap::Shared()->IsReady();
+}
+
+void OpticalFastModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+    const G4Track* track = fastTrack.GetPrimaryTrack();
+    auto map = LightCollectionMap::Shared();
+
+    // El fotón se dispara en su primer step, así que la posición actual es su vértice
+    const G4ThreeVector& pos = track->GetPosition();
+    const G4int voxel = map->VoxelIndex(pos);
+
+    if (voxel >= 0 && G4UniformRand() < map->GetEfficiency(voxel)) {
+        const G4double arrival = track->GetGlobalTime() + map->SampleTransitTime(voxel);
+        fSiPM->AddFastPhoton(arrival, map->ProjectToExitFace(pos), track->GetWeight());
+    }
+
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposePrimaryTrackPathLength(0.);
+}
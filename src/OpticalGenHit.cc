@@ -0,0 +1,3 @@
+#include "OpticalGenHit.hh"
+
+G4ThreadLocal G4Allocator<OpticalGenHit>* OpticalGenHitAllocator = nullptr;
@@ -1,21 +1,34 @@
 #include "OpticalSiPM_SD.hh"
+#include "OpticsConfig.hh"
+#include "LightCollectionMap.hh"
+#include "SiPMConfig.hh"
+#include "DetectorConstruction.hh"
 
 #include "G4Step.hh"
 #include "G4Track.hh"
 #include "G4OpticalPhoton.hh"
-#include "G4AnalysisManager.hh"
-#include "G4RunManager.hh"
-#include "G4SystemOfUnits.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
 #include "G4RandomTools.hh"
 
 OpticalSiPM_SD::OpticalSiPM_SD(const G4String& name)
-: G4VSensitiveDetector(name),
-  fPhotonCount(0)
-{}
+: G4VSensitiveDetector(name)
+{
+    collectionName.insert("SiPMHits");
+}
 
-void OpticalSiPM_SD::Initialize(G4HCofThisEvent*)
+void OpticalSiPM_SD::Initialize(G4HCofThisEvent* hce)
 {
-    fPhotonCount = 0;   // contador limpio por evento
+    fHits = new SiPMHitsCollection(SensitiveDetectorName, collectionName[0]);
+    if (fHCID < 0)
+        fHCID = G4SDManager::GetSDMpointer()->GetCollectionID(fHits);
+    hce->AddHitsCollection(fHCID, fHits);
+
+    fCalibrating = OpticsConfig::Instance()->GetLightMapMode() == LightMapMode::CALIBRATE;
+
+    auto sipm = SiPMConfig::Instance();
+    fPDE = sipm->GetPDE();
+    fPDEAtBirth = sipm->CullAtBirth();
 }
 
 G4bool OpticalSiPM_SD::ProcessHits(G4Step* step, G4TouchableHistory*)
@@ -23,48 +36,47 @@ G4bool OpticalSiPM_SD::ProcessHits(G4Step* step, G4TouchableHistory*)
     auto track = step->GetTrack();
 
     // Solo optical photons
-    if (track->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition())
+    if (track->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition())
         return false;
 
     // Solo cuando entra al volumen SiPM
-    if (step->GetPreStepPoint()->GetStepStatus() == fGeomBoundary)
+    if (step->GetPreStepPoint()->GetStepStatus() != fGeomBoundary)
         return false;
 
-    // --- PDE: probabilidad realista del SiPM ---
-    if (G4UniformRand() > fPDE)
-    {
-        track->SetTrackStatus(fStopAndKill);
-        return true;  // fotón llegó, pero no fue detectado
-    }
-
-    // --- Si fue detectado → incrementar contador ---
-    fPhotonCount++;
-
-    // Guardar algunos datos del fotón
-    auto post = step->GetPostStepPoint();
-    auto pos = post->GetPosition();
-    auto time = track->GetGlobalTime();
-
-    auto analysis = G4AnalysisManager::Instance();
-    analysis->FillNtupleDColumn(2, 0, time/ns);
-    analysis->FillNtupleDColumn(2, 1, pos.x()/mm);
-    analysis->FillNtupleDColumn(2, 2, pos.y()/mm);
-    analysis->FillNtupleDColumn(2, 3, pos.z()/mm);
-    analysis->AddNtupleRow(2);
+    // Calibración del mapa de luz: llegada antes del PDE, con el tiempo
+    // de tránsito desde el vértice del fotón
+    if (fCalibrating)
+        LightCollectionMap::Local()->AddArrival(track->GetVertexPosition(),
+                                                track->GetLocalTime());
 
     track->SetTrackStatus(fStopAndKill);
 
+    RecordPhoton(track->GetGlobalTime(),
+                 track->GetKineticEnergy(),
+                 step->GetPostStepPoint()->GetPosition(),
+                 track->GetWeight(),
+                 DetectorConstruction::GetChannel(step->GetPreStepPoint()->GetTouchable()));
+
     return true;
 }
 
-void OpticalSiPM_SD::EndOfEvent(G4HCofThisEvent*)
+// =============================================================
+// Llegada muestreada por OpticalFastModel (sin tracking óptico; solo
+// con una pieza, canal 0)
+// =============================================================
+void OpticalSiPM_SD::AddFastPhoton(G4double time, const G4ThreeVector& position, G4double weight)
 {
-    auto analysis = G4AnalysisManager::Instance();
-    auto event = G4RunManager::GetRunManager()->GetCurrentEvent();
-    G4int eventID = event->GetEventID();
-
-    analysis->FillNtupleIColumn(3, 0, eventID);     // Column 0: EventID
-    analysis->FillNtupleIColumn(3, 1, fPhotonCount); // Column 1: nPhotons
-    analysis->AddNtupleRow(3);
+    RecordPhoton(time, 0., position, weight);
 }
 
+void OpticalSiPM_SD::RecordPhoton(G4double time, G4double energy, const G4ThreeVector& pos,
+                                  G4double weight, G4int channel)
+{
+    // --- PDE: probabilidad realista del SiPM ---
+    // Con cullAtBirth ya se aplicó al crear el fotón: toda llegada cuenta
+    if (!fPDEAtBirth && G4UniformRand() > fPDE)
+        return;  // fotón llegó, pero no fue detectado
+
+    // --- Si fue detectado → un hit (el recuento es el tamaño de la colección) ---
+    fHits->insert(new SiPMHit(time, energy, pos, weight, channel));
+}
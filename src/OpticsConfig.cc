@@ -0,0 +1,105 @@
+#include "OpticsConfig.hh"
+#include "MasterCommand.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4ApplicationState.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+OpticsConfig* OpticsConfig::Instance()
+{
+    // Debe crearse primero en el maestro para registrar sus comandos
+    static OpticsConfig* instance = new OpticsConfig();
+    return instance;
+}
+
+OpticsConfig::OpticsConfig()
+: fMaxTime(50.*ns)
+{
+    // ------------------------------------------------------------
+    // Mapa de colección de luz (simulación rápida)
+    // ------------------------------------------------------------
+    fLightMapMessenger = new G4GenericMessenger(this, "/optics/lightmap/",
+                                                "Mapa de colección de luz (simulación rápida)");
+
+    auto& modeCmd = fLightMapMessenger->DeclareMethod("mode", &OpticsConfig::SetLightMapMode,
+        "off: tracking completo; calibrate: tracking completo y guarda el mapa al final del run; "
+        "fast: muestrea el mapa en lugar de seguir los fotones (requiere --fastsim).");
+    modeCmd.SetParameterName("mode", false);
+    modeCmd.SetCandidates("off calibrate fast");
+    MasterOnly(modeCmd);
+
+    auto& voxCmd = fLightMapMessenger->DeclareMethod("voxels", &OpticsConfig::SetVoxels,
+        "Número de vóxeles del mapa en X Y Z (p.ej. 7 7 16).");
+    voxCmd.SetParameterName("voxels", false);
+    MasterOnly(voxCmd);
+
+    auto& binsCmd = fLightMapMessenger->DeclareProperty("timeBins", fTimeBins,
+        "Número de bins del tiempo de llegada por vóxel.");
+    binsCmd.SetParameterName("timeBins", false);
+    binsCmd.SetRange("timeBins>0");
+    MasterOnly(binsCmd);
+
+    auto& tmaxCmd = fLightMapMessenger->DeclarePropertyWithUnit("maxTime", "ns", fMaxTime,
+        "Tiempo de tránsito máximo del histograma (los más lentos van al último bin).");
+    MasterOnly(tmaxCmd);
+
+    auto& dirCmd = fLightMapMessenger->DeclareProperty("dir", fMapDirectory,
+        "Directorio donde se guardan y buscan los mapas calibrados.");
+    MasterOnly(dirCmd);
+
+    // ------------------------------------------------------------
+    // Política de vida de los fotones ópticos (tabla de pérdidas al
+    // final del run)
+    // ------------------------------------------------------------
+    fPhotonMessenger = new G4GenericMessenger(this, "/optics/photon/",
+                                              "Criterios para dejar de seguir fotones ópticos");
+
+    auto& exitCmd = fPhotonMessenger->DeclareProperty("killOnExit", fKillOnExit,
+        "Mata los fotones que salen por refracción al aire del mundo (o de la matriz).");
+    exitCmd.SetParameterName("kill", true);
+    exitCmd.SetDefaultValue("true");
+    MasterOnly(exitCmd);
+
+    auto& timeCmd = fPhotonMessenger->DeclarePropertyWithUnit("maxTime", "ns", fPhotonMaxTime,
+        "Tiempo global máximo de un fotón (0: sin límite); p.ej. el final de la ventana del SiPM.");
+    timeCmd.SetParameterName("maxTime", false);
+    timeCmd.SetRange("maxTime>=0.");
+    MasterOnly(timeCmd);
+
+    auto& bounceCmd = fPhotonMessenger->DeclareProperty("maxBounces", fMaxBounces,
+        "Reflexiones máximas en superficies (0: sin límite); corta los fotones atrapados por RTI.");
+    bounceCmd.SetParameterName("maxBounces", false);
+    bounceCmd.SetRange("maxBounces>=0");
+    MasterOnly(bounceCmd);
+
+    auto& probCmd = fPhotonMessenger->DeclareProperty("minDetectionProbability", fMinDetectionProbability,
+        "Probabilidad de detección restante mínima (eficiencia del mapa de luz en la posición "
+        "x PDE); requiere un mapa calibrado en /optics/lightmap/dir (0: sin límite).");
+    probCmd.SetParameterName("probability", false);
+    probCmd.SetRange("probability>=0. && probability<=1.");
+    MasterOnly(probCmd);
+}
+
+void OpticsConfig::SetLightMapMode(const G4String& name)
+{
+    if      (name == "calibrate") fLightMapMode = LightMapMode::CALIBRATE;
+    else if (name == "fast")      fLightMapMode = LightMapMode::FAST;
+    else                          fLightMapMode = LightMapMode::OFF;
+}
+
+void OpticsConfig::SetVoxels(const G4String& values)
+{
+    std::istringstream is(values);
+    G4int nx = 0, ny = 0, nz = 0;
+    is >> nx >> ny >> nz;
+
+    if (nx <= 0 || ny <= 0 || nz <= 0) {
+        G4cerr << "/optics/lightmap/voxels: se esperan tres enteros positivos" << G4endl;
+        return;
+    }
+    fVoxelsX = nx;
+    fVoxelsY = ny;
+    fVoxelsZ = nz;
+}
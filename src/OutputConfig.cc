@@ -0,0 +1,73 @@
+#include "OutputConfig.hh"
+#include "MasterCommand.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4ApplicationState.hh"
+
+OutputConfig* OutputConfig::Instance()
+{
+    // Debe crearse primero en el maestro (ActionInitialization) para que
+    // los comandos queden registrados en su UI manager.
+    static OutputConfig* instance = new OutputConfig();
+    return instance;
+}
+
+OutputConfig::OutputConfig()
+{
+    fMessenger = new G4GenericMessenger(this, "/output/", "Control de la salida de ntuples");
+
+    auto& levelCmd = fMessenger->DeclareMethod("level", &OutputConfig::SetLevel,
+        "Nivel de detalle: summary (ScintEvent + SiPMSummary), track (+ ScintTrack), "
+        "step (+ ScintData) o photon (+ SiPMData y OpticalGen).");
+    levelCmd.SetParameterName("level", false);
+    levelCmd.SetCandidates("summary track step photon");
+    MasterOnly(levelCmd);
+
+    auto& histoCmd = fMessenger->DeclareProperty("histograms", fHistograms,
+        "Llena los histogramas TotalEdep, nPhotons, PhotonTime y SiPMHitMap durante el run "
+        "(binning con /analysis/h1/set y /analysis/h2/set). Con /output/level summary la "
+        "salida ocupa O(bins) en lugar de una fila por fotón.");
+    histoCmd.SetParameterName("histograms", false);
+    MasterOnly(histoCmd);
+
+    auto& formatCmd = fMessenger->DeclareMethod("format", &OutputConfig::SetFormat,
+        "Formato de los ntuples: root (output.root) o columnar (output.scol, columnas "
+        "de ancho fijo legibles con ColumnarReader sin deserializar).");
+    formatCmd.SetParameterName("format", false);
+    formatCmd.SetCandidates("root columnar");
+    MasterOnly(formatCmd);
+
+    auto& memoryCmd = fMessenger->DeclareProperty("writerMemory", fWriterMemory,
+        "Memoria máxima (MB) de bloques columnar en espera del hilo de escritura; "
+        "al llegar al tope la simulación espera al disco.");
+    memoryCmd.SetParameterName("MB", false);
+    memoryCmd.SetRange("MB>=1");
+    MasterOnly(memoryCmd);
+
+    auto& fileCmd = fMessenger->DeclareProperty("file", fFileName,
+        "Nombre base de la salida, sin extensión (output -> output.root o output.scol, output_dict.csv).");
+    fileCmd.SetParameterName("file", false);
+    MasterOnly(fileCmd);
+}
+
+void OutputConfig::SetLevel(const G4String& name)
+{
+    if      (name == "summary") fLevel = OutputLevel::SUMMARY;
+    else if (name == "track")   fLevel = OutputLevel::TRACK;
+    else if (name == "step")    fLevel = OutputLevel::STEP;
+    else                        fLevel = OutputLevel::PHOTON;
+}
+
+void OutputConfig::SetFormat(const G4String& name)
+{
+    fFormat = (name == "columnar") ? OutputFormat::COLUMNAR : OutputFormat::ROOT;
+}
+
+G4String OutputConfig::AddFileSuffix(const G4String& fileName) const
+{
+    const auto slash = fileName.find_last_of('/');
+    const auto dot = fileName.find_last_of('.');
+    if (dot == G4String::npos || (slash != G4String::npos && dot < slash))
+        return fileName + fFileSuffix;
+    return fileName.substr(0, dot) + fFileSuffix + fileName.substr(dot);
+}
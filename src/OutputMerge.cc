@@ -0,0 +1,300 @@
+#include "OutputMerge.hh"
+#include "OutputConfig.hh"
+#include "ColumnarReader.hh"
+#include "ColumnarWriter.hh"
+#include "RunAction.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4RootAnalysisReader.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// =============================================================
+// Histogramas (/output/histograms): suma bin a bin de los de cada
+// entrada. Los ejes salen de la primera entrada, no del proceso que
+// fusiona (con --workers el padre no ejecuta la macro ni sus
+// /analysis/h1/set); si otra entrada tiene otros ejes la fusión falla
+// =============================================================
+template <typename H>
+G4bool MergeHistogram(H* histogram, const H& input, G4bool first, const G4String& name,
+                      const G4String& file)
+{
+    if (first) {
+        *histogram = input;
+        return true;
+    }
+    if (!histogram->add(input)) {
+        G4cerr << "MergeOutputs: el histograma " << name << " de " << file
+               << " tiene otros ejes que el de la primera entrada" << G4endl;
+        return false;
+    }
+    return true;
+}
+
+G4bool MergeHistograms(const std::vector<G4String>& files)
+{
+    auto reader = G4RootAnalysisReader::Instance();
+    auto analysisManager = G4AnalysisManager::Instance();
+
+    for (G4int id = 0; id < analysisManager->GetNofH1s(); ++id) {
+        const auto name = analysisManager->GetH1Name(id);
+        auto h1 = analysisManager->GetH1(id);
+        h1->reset();
+        G4bool present = false;
+        for (const auto& file : files) {
+            if (access(file.c_str(), R_OK) != 0) continue;
+            const G4int readId = reader->ReadH1(name, file);
+            if (readId < 0) continue;
+            if (!MergeHistogram(h1, *reader->GetH1(readId), !present, name, file)) return false;
+            present = true;
+        }
+        analysisManager->SetH1Activation(id, present);
+    }
+
+    for (G4int id = 0; id < analysisManager->GetNofH2s(); ++id) {
+        const auto name = analysisManager->GetH2Name(id);
+        auto h2 = analysisManager->GetH2(id);
+        h2->reset();
+        G4bool present = false;
+        for (const auto& file : files) {
+            if (access(file.c_str(), R_OK) != 0) continue;
+            const G4int readId = reader->ReadH2(name, file);
+            if (readId < 0) continue;
+            if (!MergeHistogram(h2, *reader->GetH2(readId), !present, name, file)) return false;
+            present = true;
+        }
+        analysisManager->SetH2Activation(id, present);
+    }
+
+    return true;
+}
+
+// =============================================================
+// ROOT: filas copiadas con G4RootAnalysisReader (si copyNtuples) e
+// histogramas sumados
+// =============================================================
+G4bool MergeRoot(const std::vector<G4String>& inputs, const G4String& output,
+                 G4bool copyNtuples, G4long& nRows)
+{
+    const auto& schemas = NtupleSchemas();
+    auto reader = G4RootAnalysisReader::Instance();
+    reader->SetVerboseLevel(0);
+
+    std::vector<G4String> files;
+    for (const auto& input : inputs)
+        files.push_back(input + ".root");
+
+    // ntuple de lectura por (ntuple, entrada); -1 si la entrada no lo tiene
+    std::vector<std::vector<G4int>> readIds(schemas.size(), std::vector<G4int>(files.size(), -1));
+
+    auto analysisManager = G4AnalysisManager::Instance();
+    for (std::size_t s = 0; s < schemas.size(); ++s) {
+        G4bool present = false;
+        for (std::size_t f = 0; f < files.size() && copyNtuples; ++f) {
+            if (access(files[f].c_str(), R_OK) != 0) continue;   // entrada sin eventos
+            readIds[s][f] = reader->GetNtuple(schemas[s].name, files[f]);
+            present = present || readIds[s][f] >= 0;
+        }
+        analysisManager->SetNtupleActivation(static_cast<G4int>(s), present);
+    }
+
+    // Los histogramas se suman antes de abrir la salida
+    if (!MergeHistograms(files)) {
+        reader->CloseFiles();
+        return false;
+    }
+
+    if (!analysisManager->OpenFile(output + ".root")) {
+        G4cerr << "MergeOutputs: no se pudo crear " << output << ".root" << G4endl;
+        reader->CloseFiles();
+        return false;
+    }
+
+    for (std::size_t s = 0; s < schemas.size(); ++s) {
+        const auto& columns = schemas[s].columns;
+        const G4int id = static_cast<G4int>(s);
+
+        // Un valor de cada tipo por columna; solo se usa el del tipo de la columna
+        std::vector<G4int> intValues(columns.size(), 0);
+        std::vector<G4double> doubleValues(columns.size(), 0.);
+
+        for (std::size_t f = 0; f < files.size(); ++f) {
+            const G4int readId = readIds[s][f];
+            if (readId < 0) continue;
+
+            for (std::size_t c = 0; c < columns.size(); ++c) {
+                if (columns[c].type == 'I')
+                    reader->SetNtupleIColumn(readId, columns[c].name, intValues[c]);
+                else
+                    reader->SetNtupleDColumn(readId, columns[c].name, doubleValues[c]);
+            }
+
+            while (reader->GetNtupleRow(readId)) {
+                for (std::size_t c = 0; c < columns.size(); ++c) {
+                    const G4int column = static_cast<G4int>(c);
+                    if (columns[c].type == 'I')
+                        analysisManager->FillNtupleIColumn(id, column, intValues[c]);
+                    else
+                        analysisManager->FillNtupleDColumn(id, column, doubleValues[c]);
+                }
+                analysisManager->AddNtupleRow(id);
+                ++nRows;
+            }
+        }
+    }
+
+    analysisManager->Write();
+    analysisManager->CloseFile();
+
+    // Las entradas pueden reescribirse en el siguiente run: no dejar
+    // archivos abiertos en el lector
+    reader->CloseFiles();
+
+    return true;
+}
+
+// =============================================================
+// Columnar: los bloques se copian tal cual, en el orden del índice
+// de cada entrada
+// =============================================================
+G4bool MergeColumnar(const std::vector<G4String>& inputs, const G4String& output, G4long& nRows)
+{
+    std::vector<std::unique_ptr<ColumnarFile>> files;
+    std::vector<G4bool> active(NtupleSchemas().size(), false);
+
+    try {
+        for (const auto& input : inputs) {
+            const G4String fileName = input + ".scol";
+            if (access(fileName.c_str(), R_OK) != 0) continue;   // entrada sin eventos
+
+            files.push_back(std::make_unique<ColumnarFile>(fileName));
+            const auto& ntuples = files.back()->GetNtuples();
+            if (ntuples.size() != active.size()) {
+                G4cerr << "MergeOutputs: " << fileName << " tiene otro esquema" << G4endl;
+                return false;
+            }
+            for (std::size_t n = 0; n < ntuples.size(); ++n)
+                active[n] = active[n] || ntuples[n].active;
+        }
+    }
+    catch (const std::runtime_error& error) {
+        G4cerr << "MergeOutputs: " << error.what() << G4endl;
+        return false;
+    }
+
+    auto writer = ColumnarWriter::Instance();
+    if (!writer->Open(output + ".scol", active)) return false;
+
+    for (const auto& file : files) {
+        for (const auto& chunk : file->GetChunks()) {
+            writer->WriteChunk(chunk.ntuple, { { chunk.column, chunk.data, chunk.nRows } });
+            if (chunk.column == 0) nRows += static_cast<G4long>(chunk.nRows);
+        }
+    }
+    writer->Close();
+    return true;
+}
+
+G4bool CopyFile(const G4String& from, const G4String& to)
+{
+    std::ifstream in(from, std::ios::binary);
+    if (!in) return false;
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+    out << in.rdbuf();
+    return static_cast<G4bool>(out);
+}
+
+}
+
+G4bool MergeOutputs(const std::vector<G4String>& inputs, const G4String& output)
+{
+    const G4String extension = OutputConfig::Instance()->GetExtension();
+    const G4bool columnar = OutputConfig::Instance()->GetFormat() == OutputFormat::COLUMNAR;
+
+    // Sin entradas no se escribe una salida vacía encima de la existente
+    G4String dictionary;
+    std::size_t nPresent = 0;
+    for (const auto& input : inputs) {
+        if (access((input + extension).c_str(), R_OK) != 0) continue;
+        ++nPresent;
+        if (dictionary.empty() && access((input + "_dict.csv").c_str(), R_OK) == 0)
+            dictionary = input + "_dict.csv";
+    }
+    if (nPresent == 0) {
+        G4cerr << "MergeOutputs: ninguna entrada para " << output << extension << G4endl;
+        return false;
+    }
+
+    // Con el formato columnar, <base>.root solo existe si hay histogramas
+    G4bool hasRoot = !columnar;
+    for (const auto& input : inputs)
+        hasRoot = hasRoot || access((input + ".root").c_str(), R_OK) == 0;
+
+    const G4String tmp = output + ".tmp";
+    G4long nRows = 0;
+    if (columnar && !MergeColumnar(inputs, tmp, nRows))
+        return false;
+    if (hasRoot && !MergeRoot(inputs, tmp, !columnar, nRows))
+        return false;
+
+    // Los códigos de procesos salen de la misma tabla en todas las
+    // entradas: basta el diccionario de la primera
+    std::vector<G4String> suffixes = { extension };
+    if (columnar && hasRoot) suffixes.push_back(".root");
+    if (!dictionary.empty() && CopyFile(dictionary, tmp + "_dict.csv"))
+        suffixes.push_back("_dict.csv");
+
+    // Salida completa y en disco antes de sustituir a la anterior
+    for (const auto& suffix : suffixes) {
+        const G4String from = tmp + suffix;
+        const G4String to = output + suffix;
+        if (!SyncPath(from) || std::rename(from.c_str(), to.c_str()) != 0) {
+            G4cerr << "MergeOutputs: no se pudo guardar " << to << G4endl;
+            return false;
+        }
+    }
+    if (!SyncDirectoryOf(output)) {
+        G4cerr << "MergeOutputs: no se pudo sincronizar el directorio de " << output << G4endl;
+        return false;
+    }
+
+    G4cout << "\n=========== FUSIÓN DE " << inputs.size() << " SALIDAS ===========\n"
+           << "Filas copiadas: " << nRows << "\n"
+           << "Archivo de ntuples guardado como: " << output << extension << "\n"
+           << "=============================================\n";
+    return true;
+}
+
+void RemoveOutputs(const std::vector<G4String>& inputs)
+{
+    for (const auto& input : inputs) {
+        std::remove((input + ".root").c_str());
+        std::remove((input + ".scol").c_str());
+        std::remove((input + "_dict.csv").c_str());
+    }
+}
+
+// =============================================================
+// Sincronización en disco
+// =============================================================
+G4bool SyncPath(const G4String& path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    const G4bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+G4bool SyncDirectoryOf(const G4String& path)
+{
+    const std::size_t slash = path.rfind('/');
+    return SyncPath(slash == std::string::npos ? G4String(".") : G4String(path.substr(0, slash + 1)));
+}
@@ -0,0 +1,291 @@
+#include "PhaseSpace.hh"
+#include "MasterCommand.hh"
+#include "OutputConfig.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Event.hh"
+#include "G4GenericMessenger.hh"
+#include "G4ApplicationState.hh"
+#include "G4IonTable.hh"
+#include "G4ParticleTable.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[8] = { 'P', 'S', 'P', 'A', 'C', 'E', '0', '1' };
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t recordSize;
+    std::uint32_t reserved;
+    std::uint64_t sourceEvents;
+    std::uint64_t blocks;
+};
+
+struct BlockHeader
+{
+    std::uint32_t eventID;
+    std::uint32_t nRecords;
+};
+
+// Partículas del evento en curso, por hilo
+G4ThreadLocal std::vector<PhaseSpaceRecord>* fEventRecords = nullptr;
+
+std::vector<PhaseSpaceRecord>& EventRecords()
+{
+    if (!fEventRecords) fEventRecords = new std::vector<PhaseSpaceRecord>();
+    return *fEventRecords;
+}
+
+}
+
+PhaseSpace* PhaseSpace::Instance()
+{
+    // Debe crearse primero en el maestro para registrar sus comandos
+    static PhaseSpace* instance = new PhaseSpace();
+    return instance;
+}
+
+PhaseSpace::PhaseSpace()
+{
+    fMessenger = new G4GenericMessenger(this, "/phasespace/",
+                                        "Espacio de fases en la entrada del centellador");
+
+    auto& recordCmd = fMessenger->DeclareProperty("record", fRecordName,
+        "Graba las partículas cargadas y gammas que entran al centellador en este archivo "
+        "(none: no se graba). Se reescribe en cada run.");
+    recordCmd.SetParameterName("file", false);
+    MasterOnly(recordCmd);
+
+    auto& replayCmd = fMessenger->DeclareProperty("replay", fReplayName,
+        "Genera los primarios a partir de un archivo grabado con /phasespace/record "
+        "(none: fuente de neutrones).");
+    replayCmd.SetParameterName("file", false);
+    MasterOnly(replayCmd);
+}
+
+// =============================================================
+// Ciclo de vida por run
+// =============================================================
+void PhaseSpace::BeginOfRun(G4bool isMaster)
+{
+    // El maestro abre los archivos antes de que empiecen los workers
+    if (!isMaster) return;
+
+    auto phaseSpace = Instance();
+    if (phaseSpace->fRecordName != "none") phaseSpace->OpenRecord();
+    if (phaseSpace->fReplayName != "none") phaseSpace->OpenReplay();
+}
+
+void PhaseSpace::EndOfRun(G4bool isMaster)
+{
+    // Los workers terminan su run antes que el maestro
+    if (!isMaster) return;
+
+    auto phaseSpace = Instance();
+    phaseSpace->CloseRecord();
+    phaseSpace->CloseReplay();
+}
+
+// =============================================================
+// Grabación
+// =============================================================
+G4bool PhaseSpace::OpenRecord()
+{
+    // Un archivo por proceso con --workers (ps_w<i>.bin)
+    fRecordPath = OutputConfig::Instance()->AddFileSuffix(fRecordName);
+    fRecordFile = std::fopen(fRecordPath.c_str(), "wb");
+    if (!fRecordFile) {
+        G4cerr << "PhaseSpace: no se pudo crear " << fRecordPath << G4endl;
+        return false;
+    }
+
+    fSourceEvents = 0;
+    fBlocks = 0;
+
+    // Cabecera provisional; los contadores se escriben al cerrar
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.recordSize = sizeof(PhaseSpaceRecord);
+    std::fwrite(&header, sizeof(header), 1, fRecordFile);
+
+    G4cout << "Espacio de fases: grabando en " << fRecordPath << G4endl;
+    return true;
+}
+
+void PhaseSpace::CloseRecord()
+{
+    if (!fRecordFile) return;
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.recordSize = sizeof(PhaseSpaceRecord);
+    header.sourceEvents = fSourceEvents;
+    header.blocks = fBlocks;
+
+    std::fseek(fRecordFile, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, fRecordFile);
+    std::fclose(fRecordFile);
+    fRecordFile = nullptr;
+
+    G4cout << "Espacio de fases guardado: " << fRecordPath << " (" << fBlocks
+           << " eventos con partículas de " << fSourceEvents << ")" << G4endl;
+}
+
+void PhaseSpace::BeginOfEvent()
+{
+    if (IsRecording()) EventRecords().clear();
+}
+
+void PhaseSpace::Record(const G4Track* track, const G4ThreeVector& position,
+                        const G4ThreeVector& direction, G4double ekin, G4double time)
+{
+    PhaseSpaceRecord record;
+    record.pdg = track->GetDefinition()->GetPDGEncoding();
+    record.ekin = static_cast<float>(ekin / MeV);
+    record.x = static_cast<float>(position.x() / mm);
+    record.y = static_cast<float>(position.y() / mm);
+    record.z = static_cast<float>(position.z() / mm);
+    record.dx = static_cast<float>(direction.x());
+    record.dy = static_cast<float>(direction.y());
+    record.dz = static_cast<float>(direction.z());
+    record.time = static_cast<float>(time / ns);
+    record.weight = static_cast<float>(track->GetWeight());
+
+    EventRecords().push_back(record);
+}
+
+void PhaseSpace::EndOfEvent(G4int eventID)
+{
+    if (!IsRecording()) return;
+
+    auto& records = EventRecords();
+
+    G4AutoLock lock(&fWriteMutex);
+    fSourceEvents++;
+    if (records.empty()) return;
+
+    const BlockHeader block{ static_cast<std::uint32_t>(eventID),
+                             static_cast<std::uint32_t>(records.size()) };
+    std::fwrite(&block, sizeof(block), 1, fRecordFile);
+    std::fwrite(records.data(), sizeof(PhaseSpaceRecord), records.size(), fRecordFile);
+    fBlocks++;
+}
+
+// =============================================================
+// Reproducción
+// =============================================================
+G4bool PhaseSpace::OpenReplay()
+{
+    const int fd = open(fReplayName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        G4cerr << "PhaseSpace: no se pudo abrir " << fReplayName << G4endl;
+        return false;
+    }
+
+    struct stat info;
+    fstat(fd, &info);
+    const std::size_t size = static_cast<std::size_t>(info.st_size);
+
+    void* data = (size >= sizeof(Header)) ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)
+                                          : MAP_FAILED;
+    close(fd);   // la proyección sigue siendo válida
+
+    if (data == MAP_FAILED) {
+        G4cerr << "PhaseSpace: no se pudo proyectar " << fReplayName << G4endl;
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.recordSize != sizeof(PhaseSpaceRecord) || header.blocks == 0) {
+        G4cerr << "PhaseSpace: " << fReplayName << " no es un espacio de fases válido" << G4endl;
+        munmap(data, size);
+        return false;
+    }
+
+    // Índice de bloques (una pasada por las cabeceras, sin copiar registros)
+    const char* bytes = static_cast<const char*>(data);
+    fBlockOffsets.clear();
+    fBlockOffsets.reserve(header.blocks);
+
+    std::size_t offset = sizeof(Header);
+    while (offset + sizeof(BlockHeader) <= size && fBlockOffsets.size() < header.blocks) {
+        BlockHeader block;
+        std::memcpy(&block, bytes + offset, sizeof(block));
+        const std::size_t next = offset + sizeof(block) + block.nRecords * sizeof(PhaseSpaceRecord);
+        if (next > size) break;   // bloque truncado
+        fBlockOffsets.push_back(offset);
+        offset = next;
+    }
+
+    // Todos los bloques truncados: nada que reproducir (GeneratePrimaries
+    // indexa módulo el número de bloques)
+    if (fBlockOffsets.empty()) {
+        G4cerr << "PhaseSpace: " << fReplayName << " no tiene ningún bloque completo" << G4endl;
+        munmap(data, size);
+        return false;
+    }
+
+    fData = bytes;
+    fSize = size;
+
+    G4cout << "Espacio de fases: " << fReplayName << " (" << fBlockOffsets.size()
+           << " eventos con partículas de " << header.sourceEvents << " eventos fuente)" << G4endl;
+    return true;
+}
+
+void PhaseSpace::CloseReplay()
+{
+    if (!fData) return;
+
+    munmap(const_cast<char*>(fData), fSize);
+    fData = nullptr;
+    fSize = 0;
+    fBlockOffsets.clear();
+}
+
+void PhaseSpace::GeneratePrimaries(G4Event* event) const
+{
+    const std::size_t index = static_cast<std::size_t>(event->GetEventID()) % fBlockOffsets.size();
+    const char* block = fData + fBlockOffsets[index];
+
+    BlockHeader header;
+    std::memcpy(&header, block, sizeof(header));
+    const char* records = block + sizeof(header);
+
+    auto particleTable = G4ParticleTable::GetParticleTable();
+
+    for (std::uint32_t i = 0; i < header.nRecords; ++i) {
+        PhaseSpaceRecord record;
+        std::memcpy(&record, records + i * sizeof(PhaseSpaceRecord), sizeof(record));
+
+        // Iones (alpha, Li7) por código PDG
+        auto definition = particleTable->FindParticle(record.pdg);
+        if (!definition && record.pdg > 1000000000)
+            definition = G4IonTable::GetIonTable()->GetIon(record.pdg);
+        if (!definition) continue;
+
+        auto particle = new G4PrimaryParticle(definition);
+        particle->SetKineticEnergy(record.ekin * MeV);
+        particle->SetMomentumDirection(G4ThreeVector(record.dx, record.dy, record.dz));
+        particle->SetWeight(record.weight);
+
+        auto vertex = new G4PrimaryVertex(G4ThreeVector(record.x, record.y, record.z) * mm,
+                                          record.time * ns);
+        vertex->SetPrimary(particle);
+        event->AddPrimaryVertex(vertex);
+    }
+}
@@ -0,0 +1,225 @@
+#include "PhotonPolicy.hh"
+#include "OpticsConfig.hh"
+#include "SiPMConfig.hh"
+#include "LightCollectionMap.hh"
+
+#include "G4AutoLock.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4OpBoundaryProcess.hh"
+#include "G4OpProcessSubType.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4ProcessManager.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+G4ThreadLocal PhotonLossTable* fLocalTable = nullptr;
+
+constexpr std::size_t Index(PhotonFate fate) { return static_cast<std::size_t>(fate); }
+
+// Etiquetas de la tabla, en el orden de PhotonFate
+const char* const kFateNames[] = {
+    "SiPM (antes del PDE)",
+    "absorbido",
+    "sale del mundo",
+    "killOnExit",
+    "maxTime",
+    "maxBounces",
+    "minDetectionProbability",
+    "otros"
+};
+}
+
+// =============================================================
+// Estado por hilo
+// =============================================================
+void PhotonLossTable::Configure()
+{
+    counts.fill(0);
+    bounces = 0;
+
+    auto optics = OpticsConfig::Instance();
+    active = optics->PhotonPolicyActive();
+    if (!active) return;
+
+    killOnExit     = optics->KillOnExit();
+    maxTime        = optics->GetPhotonMaxTime();
+    maxBounces     = optics->GetMaxBounces();
+    minProbability = optics->GetMinDetectionProbability();
+
+    auto sipm = SiPMConfig::Instance();
+    pde = sipm->CullAtBirth() ? 1. : sipm->GetPDE();
+
+    // Mapa de luz: solo lectura, cargado por el maestro en este run
+    auto shared = LightCollectionMap::Shared();
+    map = (minProbability > 0. && shared->IsReady()) ? shared : nullptr;
+
+    // La geometría se reconstruye con /det/...: se buscan los volúmenes en cada run
+    auto store = G4LogicalVolumeStore::GetInstance();
+    escapeVolumes.clear();
+    for (const char* name : { "World", "ScintArray", "ArrayColumn", "ArrayCell" }) {
+        if (auto volume = store->GetVolume(name, false))
+            escapeVolumes.push_back(volume);
+    }
+    sipmVolume = store->GetVolume("SiPM", false);
+
+    // El proceso de frontera es propio de cada hilo
+    boundary = nullptr;
+    auto processManager = G4OpticalPhoton::OpticalPhotonDefinition()->GetProcessManager();
+    auto processes = processManager ? processManager->GetProcessList() : nullptr;
+    for (std::size_t i = 0; processes && i < processes->size(); ++i) {
+        boundary = dynamic_cast<G4OpBoundaryProcess*>((*processes)[i]);
+        if (boundary) break;
+    }
+}
+
+void PhotonLossTable::Apply(const G4Step* step)
+{
+    G4Track* track = step->GetTrack();
+    if (track->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition())
+        return;
+
+    if (track->GetCurrentStepNumber() == 1)
+        bounces = 0;
+
+    // Terminado en este step por la física, el SD o la frontera del mundo
+    if (track->GetTrackStatus() != fAlive) {
+        counts[Index(NaturalFate(step))]++;
+        return;
+    }
+
+    const G4StepPoint* post = step->GetPostStepPoint();
+
+    if (maxTime > 0. && post->GetGlobalTime() > maxTime) {
+        Kill(step, PhotonFate::TIME);
+        return;
+    }
+
+    if (post->GetStepStatus() != fGeomBoundary || !boundary)
+        return;
+
+    switch (boundary->GetStatus()) {
+        case FresnelRefraction:
+        case Transmission: {
+            // Refractado al aire: sin envoltura no vuelve al centellador
+            if (!killOnExit) break;
+            const G4LogicalVolume* next = post->GetPhysicalVolume()->GetLogicalVolume();
+            if (std::find(escapeVolumes.begin(), escapeVolumes.end(), next) != escapeVolumes.end()) {
+                Kill(step, PhotonFate::EXIT);
+                return;
+            }
+            break;
+        }
+        case TotalInternalReflection:
+        case FresnelReflection:
+        case LambertianReflection:
+        case LobeReflection:
+        case SpikeReflection:
+        case BackScattering:
+            if (maxBounces > 0 && ++bounces > maxBounces) {
+                Kill(step, PhotonFate::BOUNCES);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+
+    // Probabilidad restante: eficiencia del mapa en el punto medio del
+    // step (dentro del centellador aunque el step acabe en una cara)
+    if (map) {
+        const G4ThreeVector middle = 0.5 * (step->GetPreStepPoint()->GetPosition() + post->GetPosition());
+        const G4int voxel = map->VoxelIndex(middle);
+        if (voxel >= 0 && map->GetEfficiency(voxel) * pde < minProbability)
+            Kill(step, PhotonFate::PROBABILITY);
+    }
+}
+
+void PhotonLossTable::Kill(const G4Step* step, PhotonFate fate)
+{
+    step->GetTrack()->SetTrackStatus(fStopAndKill);
+    counts[Index(fate)]++;
+}
+
+PhotonFate PhotonLossTable::NaturalFate(const G4Step* step) const
+{
+    const G4StepPoint* post = step->GetPostStepPoint();
+    if (!post->GetPhysicalVolume() || post->GetStepStatus() == fWorldBoundary)
+        return PhotonFate::WORLD;
+
+    // OpticalSiPM_SD mata el fotón al entrar al SiPM
+    if (step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume() == sipmVolume)
+        return PhotonFate::SIPM;
+
+    const G4VProcess* process = post->GetProcessDefinedStep();
+    if (process && process->GetProcessSubType() == fOpAbsorption)
+        return PhotonFate::ABSORBED;
+
+    return PhotonFate::OTHER;
+}
+
+// =============================================================
+// Singleton y ciclo de vida por run
+// =============================================================
+PhotonPolicy* PhotonPolicy::Instance()
+{
+    static PhotonPolicy* instance = new PhotonPolicy();
+    return instance;
+}
+
+PhotonLossTable* PhotonPolicy::Local()
+{
+    if (!fLocalTable) fLocalTable = new PhotonLossTable();
+    return fLocalTable;
+}
+
+void PhotonPolicy::BeginOfRun(G4bool isMaster)
+{
+    Local()->Configure();
+
+    // El maestro empieza su run antes que los workers
+    if (isMaster) Instance()->fTotals.fill(0);
+}
+
+void PhotonPolicy::EndOfRun(G4bool isMaster)
+{
+    auto local = Local();
+    if (!local->active) return;
+
+    // Los workers terminan su run antes que el maestro
+    auto policy = Instance();
+    policy->Merge(*local);
+
+    if (isMaster) policy->Report();
+}
+
+void PhotonPolicy::Merge(const PhotonLossTable& table)
+{
+    G4AutoLock lock(&fMergeMutex);
+    for (std::size_t i = 0; i < fTotals.size(); ++i)
+        fTotals[i] += table.counts[i];
+}
+
+void PhotonPolicy::Report() const
+{
+    G4long total = 0;
+    for (G4long count : fTotals) total += count;
+
+    G4cout << "\n=========== FOTONES ÓPTICOS: DESTINO ===========\n"
+           << "Fotones seguidos: " << total << G4endl;
+
+    char line[128];
+    for (std::size_t i = 0; i < fTotals.size(); ++i) {
+        const G4double fraction = total ? 100. * fTotals[i] / total : 0.;
+        std::snprintf(line, sizeof(line), "  %-26s %14ld %7.2f%%\n",
+                      kFateNames[i], fTotals[i], fraction);
+        G4cout << line;
+    }
+    G4cout << "================================================" << G4endl;
+}
@@ -0,0 +1,167 @@
+#include "PhysicsCache.hh"
+
+#include "G4VUserPhysicsList.hh"
+#include "G4Material.hh"
+#include "G4MaterialPropertiesTable.hh"
+#include "G4IonisParamMat.hh"
+#include "G4Element.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Version.hh"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+const char* kChecksumFile = "checksum.txt";
+const char* kCompleteFile = "complete";
+
+// FNV-1a de 64 bits: suficiente para separar configuraciones; la
+// descripción completa se compara además al recuperar
+std::uint64_t Hash(const std::string& text)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string ReadFile(const std::string& fileName)
+{
+    std::ifstream in(fileName);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+}
+
+PhysicsCache::PhysicsCache(const G4String& directory, const G4String& physicsTag)
+: fRoot(directory),
+  fPhysicsTag(physicsTag)
+{}
+
+// =============================================================
+// Todo lo que determina el contenido de las tablas
+// =============================================================
+G4String PhysicsCache::Describe() const
+{
+    std::ostringstream desc;
+    desc << std::setprecision(10);
+
+    desc << "geant4 " << G4Version << " " << G4VERSION_NUMBER << "\n";
+    desc << "physics " << fPhysicsTag << "\n";
+
+    for (const auto mat : *G4Material::GetMaterialTable()) {
+        desc << "material " << mat->GetName()
+             << " density " << mat->GetDensity()
+             << " state " << mat->GetState()
+             << " T " << mat->GetTemperature()
+             << " P " << mat->GetPressure();
+        if (mat->GetIonisation())
+            desc << " birks " << mat->GetIonisation()->GetBirksConstant();
+        desc << "\n";
+
+        const G4double* fractions = mat->GetFractionVector();
+        for (std::size_t i = 0; i < mat->GetNumberOfElements(); ++i) {
+            const G4Element* element = mat->GetElement(static_cast<G4int>(i));
+            desc << "  element " << element->GetName() << " " << fractions[i];
+            for (std::size_t j = 0; j < element->GetNumberOfIsotopes(); ++j)
+                desc << " " << element->GetIsotope(static_cast<G4int>(j))->GetN()
+                     << ":" << element->GetRelativeAbundanceVector()[j];
+            desc << "\n";
+        }
+
+        // Propiedades ópticas (DefineOpticalProperties y demás)
+        auto mpt = mat->GetMaterialPropertiesTable();
+        if (!mpt) continue;
+
+        for (const auto& key : mpt->GetMaterialPropertyNames()) {
+            auto property = mpt->GetProperty(key);
+            if (!property) continue;
+            desc << "  property " << key;
+            for (std::size_t k = 0; k < property->GetVectorLength(); ++k)
+                desc << " " << property->Energy(k) << ":" << (*property)[k];
+            desc << "\n";
+        }
+        for (const auto& key : mpt->GetMaterialConstPropertyNames()) {
+            if (mpt->ConstPropertyExists(key))
+                desc << "  const " << key << " " << mpt->GetConstProperty(key) << "\n";
+        }
+    }
+
+    for (const auto region : *G4RegionStore::GetInstance()) {
+        auto cuts = region->GetProductionCuts();
+        desc << "region " << region->GetName();
+        if (cuts) {
+            for (const auto& particle : { "gamma", "e-", "e+", "proton" })
+                desc << " " << cuts->GetProductionCut(particle);
+        }
+        desc << "\n";
+    }
+
+    return desc.str();
+}
+
+// =============================================================
+// Antes del primer run
+// =============================================================
+void PhysicsCache::Prepare(G4VUserPhysicsList* physicsList)
+{
+    fDescription = Describe();
+
+    std::ostringstream hex;
+    hex << std::hex << std::setw(16) << std::setfill('0') << Hash(fDescription);
+    fDirectory = fRoot + "/" + hex.str();
+
+    namespace fs = std::filesystem;
+    const G4bool complete = fs::exists(fDirectory + "/" + kCompleteFile);
+
+    if (complete && ReadFile(fDirectory + "/" + kChecksumFile) == fDescription) {
+        physicsList->SetPhysicsTableRetrieved(fDirectory);
+        fRetrieving = true;
+        G4cout << "Caché de física: recuperando tablas de " << fDirectory << G4endl;
+        return;
+    }
+
+    // Sin caché válida: se construyen las tablas y se guardan al terminar
+    std::error_code error;
+    fs::remove_all(fDirectory, error);
+    fs::create_directories(fDirectory, error);
+    if (error) {
+        G4cerr << "PhysicsCache: no se pudo crear " << fDirectory
+               << " (" << error.message() << "); caché desactivada" << G4endl;
+        fDirectory.clear();
+        return;
+    }
+    G4cout << "Caché de física: sin tablas válidas, se guardarán en " << fDirectory << G4endl;
+}
+
+// =============================================================
+// Después del primer run. La recuperación vale solo para ese run:
+// si la macro añade luego un material (p. ej. /det/scintType), sus
+// tablas no están en la caché y deben construirse, no leerse
+// =============================================================
+void PhysicsCache::Finish(G4VUserPhysicsList* physicsList)
+{
+    if (fRetrieving) physicsList->ResetPhysicsTableRetrieved();
+    if (fRetrieving || fDirectory.empty()) return;
+
+    if (!physicsList->StorePhysicsTable(fDirectory)) {
+        G4cerr << "PhysicsCache: no se pudieron guardar las tablas en " << fDirectory << G4endl;
+        return;
+    }
+
+    // La marca se escribe al final: una caché a medias nunca se recupera
+    std::ofstream(fDirectory + "/" + kChecksumFile) << fDescription;
+    std::ofstream(fDirectory + "/" + kCompleteFile) << "ok\n";
+
+    G4cout << "Caché de física: tablas guardadas en " << fDirectory << G4endl;
+}
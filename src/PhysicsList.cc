@@ -0,0 +1,49 @@
+#include "PhysicsList.hh"
+#include "OpticsConfig.hh"
+
+#include "QGSP_BIC_HP.hh"
+#include "G4OpticalPhysics.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4GenericBiasingPhysics.hh"
+
+G4VModularPhysicsList* CreatePhysicsList(G4bool fastSim, G4bool bias)
+{
+    // Física Hadron + Física Óptica
+    auto* physicsList = new QGSP_BIC_HP();
+    physicsList->SetVerboseLevel(0);
+    // ----------------------------------
+    // DESACTIVAR RADIOACTIVE DECAY
+    // ----------------------------------
+    physicsList->RemovePhysics("G4DecayPhysics");
+    physicsList->RemovePhysics("G4RadioactiveDecay");
+
+    // Física óptica (NADA MÁS)
+    auto* opticalPhysics = new G4OpticalPhysics();
+    physicsList->RegisterPhysics(opticalPhysics);
+
+    // Simulación rápida de fotones ópticos en el centellador
+    if (fastSim) {
+        auto* fastSimPhysics = new G4FastSimulationPhysics();
+        fastSimPhysics->ActivateFastSimulation("opticalphoton");
+        physicsList->RegisterPhysics(fastSimPhysics);
+    }
+    OpticsConfig::Instance()->SetFastSimPhysics(fastSim);
+
+    // Biasing genérico de los procesos del neutrón: el operador de
+    // colisión forzada se asocia al grafeno en ConstructSDandField
+    if (bias) {
+        auto* biasingPhysics = new G4GenericBiasingPhysics();
+        biasingPhysics->Bias("neutron");
+        physicsList->RegisterPhysics(biasingPhysics);
+    }
+
+    return physicsList;
+}
+
+G4String PhysicsListTag(G4bool fastSim, G4bool bias)
+{
+    G4String tag = "QGSP_BIC_HP-G4DecayPhysics-G4RadioactiveDecay+G4OpticalPhysics";
+    if (fastSim) tag += "+G4FastSimulationPhysics(opticalphoton)";
+    if (bias) tag += "+G4GenericBiasingPhysics(neutron)";
+    return tag;
+}
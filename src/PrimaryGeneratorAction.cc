@@ -1,4 +1,5 @@
 #include "PrimaryGeneratorAction.hh"
+#include "PhaseSpace.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4SystemOfUnits.hh"
@@ -26,5 +27,12 @@ PrimaryGeneratorAction::~PrimaryGeneratorAction()
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* event)
 {
+    // Segunda etapa: partículas grabadas en la entrada del centellador
+    auto phaseSpace = PhaseSpace::Instance();
+    if (phaseSpace->IsReplaying()) {
+        phaseSpace->GeneratePrimaries(event);
+        return;
+    }
+
     fParticleGun->GeneratePrimaryVertex(event);
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "ProcessDictionary.hh"
+
+#include "G4AutoLock.hh"
+#include "G4ProcessTable.hh"
+#include "G4VProcess.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <fstream>
+
+namespace {
+// Caché por hilo: puntero del proceso -> código
+G4ThreadLocal std::unordered_map<const G4VProcess*, G4int>* fCache = nullptr;
+}
+
+ProcessDictionary* ProcessDictionary::Instance()
+{
+    static ProcessDictionary* instance = new ProcessDictionary();
+    return instance;
+}
+
+ProcessDictionary::ProcessDictionary()
+{
+    fNames.push_back("primary");
+    fCodes["primary"] = 0;
+}
+
+void ProcessDictionary::RegisterProcessTable()
+{
+    auto nameList = G4ProcessTable::GetProcessTable()->GetNameList();
+    if (!nameList) return;
+
+    std::vector<G4String> names(nameList->begin(), nameList->end());
+    std::sort(names.begin(), names.end());
+
+    for (const auto& name : names)
+        Intern(name);
+}
+
+G4int ProcessDictionary::GetCode(const G4VProcess* process)
+{
+    if (!process) return 0;
+
+    if (!fCache) fCache = new std::unordered_map<const G4VProcess*, G4int>();
+
+    auto it = fCache->find(process);
+    if (it != fCache->end()) return it->second;
+
+    G4int code = Intern(process->GetProcessName());
+    fCache->emplace(process, code);
+    return code;
+}
+
+G4int ProcessDictionary::Intern(const G4String& name)
+{
+    G4AutoLock lock(&fMutex);
+
+    auto it = fCodes.find(name);
+    if (it != fCodes.end()) return it->second;
+
+    G4int code = static_cast<G4int>(fNames.size());
+    fNames.push_back(name);
+    fCodes.emplace(name, code);
+    return code;
+}
+
+void ProcessDictionary::Write(const G4String& fileName) const
+{
+    G4AutoLock lock(&fMutex);
+
+    std::ofstream out(fileName);
+    if (!out) {
+        G4cerr << "ProcessDictionary: no se pudo escribir " << fileName << G4endl;
+        return;
+    }
+
+    // Las partículas se guardan con su código PDG estándar y no necesitan tabla
+    out << "# code,process\n";
+    for (std::size_t i = 0; i < fNames.size(); ++i)
+        out << i << ',' << fNames[i] << '\n';
+}
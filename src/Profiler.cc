@@ -0,0 +1,233 @@
+#include "Profiler.hh"
+#include "MasterCommand.hh"
+#include "OutputConfig.hh"
+
+#include "G4AutoLock.hh"
+#include "G4GenericMessenger.hh"
+#include "G4ApplicationState.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+namespace {
+G4ThreadLocal ProfileTable* fLocalTable = nullptr;
+}
+
+// =============================================================
+// Contadores por hilo
+// =============================================================
+void ProfileTable::Clear()
+{
+    particles.clear();
+    processes.clear();
+    volumes.clear();
+    steps = tracks = opticalPhotons = 0;
+    seconds = 0.;
+}
+
+void ProfileTable::StartTrack(const G4Track* track)
+{
+    tracks++;
+    if (track->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition())
+        opticalPhotons++;
+
+    if (level == ProfileLevel::TIME)
+        lastTime = std::chrono::steady_clock::now();
+}
+
+void ProfileTable::RecordStep(const G4Step* step)
+{
+    // El tiempo desde el step anterior (o el inicio del track) se
+    // atribuye a este step: transporte, procesos y SDs
+    G4double dt = 0.;
+    if (level == ProfileLevel::TIME) {
+        const auto now = std::chrono::steady_clock::now();
+        dt = std::chrono::duration<G4double>(now - lastTime).count();
+        lastTime = now;
+    }
+
+    steps++;
+    seconds += dt;
+
+    auto& particle = particles[step->GetTrack()->GetDefinition()];
+    particle.steps++;
+    particle.seconds += dt;
+
+    auto& process = processes[step->GetPostStepPoint()->GetProcessDefinedStep()];
+    process.steps++;
+    process.seconds += dt;
+
+    auto& volume = volumes[step->GetPreStepPoint()->GetPhysicalVolume()];
+    volume.steps++;
+    volume.seconds += dt;
+}
+
+// =============================================================
+// Configuración y fusión
+// =============================================================
+Profiler* Profiler::Instance()
+{
+    // Debe crearse primero en el maestro para registrar sus comandos
+    static Profiler* instance = new Profiler();
+    return instance;
+}
+
+ProfileTable* Profiler::Local()
+{
+    if (!fLocalTable) fLocalTable = new ProfileTable();
+    return fLocalTable;
+}
+
+Profiler::Profiler()
+{
+    fMessenger = new G4GenericMessenger(this, "/profile/",
+                                        "Perfil de steps por partícula, proceso y volumen");
+
+    auto& levelCmd = fMessenger->DeclareMethod("level", &Profiler::SetLevel,
+        "off: sin instrumentación; count: steps y tracks por partícula, proceso y volumen; "
+        "time: además el tiempo de pared por step (añade dos lecturas de reloj por step).");
+    levelCmd.SetParameterName("level", false);
+    levelCmd.SetCandidates("off count time");
+    MasterOnly(levelCmd);
+
+    auto& fileCmd = fMessenger->DeclareProperty("file", fFileName,
+        "CSV donde se guarda el perfil al final del run (none: no se guarda).");
+    fileCmd.SetParameterName("file", false);
+    MasterOnly(fileCmd);
+
+    auto& topCmd = fMessenger->DeclareProperty("top", fTop,
+        "Entradas por categoría que se imprimen en el ranking.");
+    topCmd.SetParameterName("top", false);
+    topCmd.SetRange("top>0");
+    MasterOnly(topCmd);
+}
+
+void Profiler::SetLevel(const G4String& name)
+{
+    if      (name == "count") fLevel = ProfileLevel::COUNT;
+    else if (name == "time")  fLevel = ProfileLevel::TIME;
+    else                      fLevel = ProfileLevel::OFF;
+}
+
+void Profiler::BeginOfRun(G4bool isMaster)
+{
+    auto profiler = Instance();
+
+    auto local = Local();
+    local->Clear();
+    local->level = profiler->fLevel;
+
+    // El maestro empieza su run antes que los workers
+    if (isMaster) {
+        profiler->fEntries.clear();
+        profiler->fTotalSteps = 0;
+        profiler->fTotalTracks = 0;
+        profiler->fTotalOpticalPhotons = 0;
+        profiler->fTotalSeconds = 0.;
+    }
+}
+
+void Profiler::EndOfRun(G4bool isMaster)
+{
+    auto profiler = Instance();
+    if (profiler->fLevel == ProfileLevel::OFF) return;
+
+    // Los workers terminan su run antes que el maestro
+    profiler->Merge(*Local());
+
+    if (isMaster) profiler->Report();
+}
+
+void Profiler::Merge(const ProfileTable& table)
+{
+    G4AutoLock lock(&fMergeMutex);
+
+    for (const auto& kv : table.particles) {
+        auto& entry = fEntries["particle"][kv.first->GetParticleName()];
+        entry.steps += kv.second.steps;
+        entry.seconds += kv.second.seconds;
+    }
+    for (const auto& kv : table.processes) {
+        auto& entry = fEntries["process"][kv.first ? kv.first->GetProcessName() : G4String("none")];
+        entry.steps += kv.second.steps;
+        entry.seconds += kv.second.seconds;
+    }
+    for (const auto& kv : table.volumes) {
+        auto& entry = fEntries["volume"][kv.first ? kv.first->GetName() : G4String("none")];
+        entry.steps += kv.second.steps;
+        entry.seconds += kv.second.seconds;
+    }
+
+    fTotalSteps += table.steps;
+    fTotalTracks += table.tracks;
+    fTotalOpticalPhotons += table.opticalPhotons;
+    fTotalSeconds += table.seconds;
+}
+
+// =============================================================
+// Ranking al final del run
+// =============================================================
+void Profiler::Report() const
+{
+    const G4bool timed = fLevel == ProfileLevel::TIME;
+
+    G4cout << "\n=========== PERFIL DEL RUN ===========\n"
+           << "Steps: " << fTotalSteps << "   Tracks: " << fTotalTracks
+           << "   Fotones ópticos: " << fTotalOpticalPhotons;
+    if (timed) G4cout << "   Tiempo de pared en steps: " << fTotalSeconds << " s";
+    G4cout << G4endl;
+
+    for (const auto& category : fEntries) {
+        // Orden por tiempo (time) o por número de steps (count)
+        std::vector<std::pair<G4String, ProfileEntry>> ranked(category.second.begin(),
+                                                              category.second.end());
+        std::sort(ranked.begin(), ranked.end(), [timed](const auto& a, const auto& b) {
+            return timed ? a.second.seconds > b.second.seconds : a.second.steps > b.second.steps;
+        });
+
+        G4cout << "\n--- por " << category.first << " ---\n";
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-28s %14s %7s %12s %7s %10s\n",
+                      "nombre", "steps", "%", "pared[s]", "%", "us/step");
+        G4cout << line;
+
+        const std::size_t n = std::min<std::size_t>(ranked.size(), fTop);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& entry = ranked[i].second;
+            const G4double stepFraction = fTotalSteps ? 100. * entry.steps / fTotalSteps : 0.;
+            const G4double timeFraction = fTotalSeconds > 0. ? 100. * entry.seconds / fTotalSeconds : 0.;
+            const G4double perStep = entry.steps ? 1.e6 * entry.seconds / entry.steps : 0.;
+            std::snprintf(line, sizeof(line), "  %-28s %14ld %6.2f%% %12.4f %6.2f%% %10.3f\n",
+                          ranked[i].first.c_str(), entry.steps, stepFraction,
+                          entry.seconds, timeFraction, perStep);
+            G4cout << line;
+        }
+    }
+    G4cout << "======================================" << G4endl;
+
+    if (fFileName.empty() || fFileName == "none") return;
+
+    // Un archivo por proceso (--workers) o bloque (--checkpoint)
+    const G4String fileName = OutputConfig::Instance()->AddFileSuffix(fFileName);
+
+    std::ofstream out(fileName);
+    if (!out) {
+        G4cerr << "Profiler: no se pudo escribir " << fileName << G4endl;
+        return;
+    }
+    out << "# category,name,steps,wall_seconds\n";
+    for (const auto& category : fEntries)
+        for (const auto& kv : category.second)
+            out << category.first << "," << kv.first << ","
+                << kv.second.steps << "," << kv.second.seconds << "\n";
+
+    G4cout << "Perfil guardado en: " << fileName << G4endl;
+}
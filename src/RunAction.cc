@@ -1,102 +1,235 @@
 #include "RunAction.hh"
+#include "OutputConfig.hh"
+#include "ProcessDictionary.hh"
+#include "LightCollectionMap.hh"
+#include "SiPMConfig.hh"
+#include "Profiler.hh"
+#include "PhotonPolicy.hh"
+#include "EventTriage.hh"
+#include "PhaseSpace.hh"
+#include "ColumnarWriter.hh"
+#include "DetectorConstruction.hh"
 #include "G4Run.hh"
+#include "G4RunManager.hh"
 #include "G4AnalysisManager.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 #include "G4ios.hh"
+#include "G4Threading.hh"
 
-RunAction::RunAction() : G4UserRunAction() {}
-RunAction::~RunAction() {}
+namespace {
+// Zona de SiPMs de la geometría actual; sin detector, la del SiPM por defecto
+G4ThreeVector SiPMPlaneHalfSize()
+{
+    auto detector = static_cast<const DetectorConstruction*>(
+        G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    return detector ? detector->GetSiPMPlaneHalfSize() : G4ThreeVector(23.5*mm, 23.5*mm, 0.5*mm);
+}
+}
 
-void RunAction::BeginOfRunAction(const G4Run*)
-{      
-    auto analysisManager = G4AnalysisManager::Instance();
+// =============================================================
+// Definición de los ntuples, en el orden de NtupleId.
+// Las columnas *ID usan los códigos de output_dict.csv y Weight es el
+// peso estadístico (1 sin --bias).
+// =============================================================
+const std::vector<NtupleSchema>& NtupleSchemas()
+{
+    static const std::vector<NtupleSchema> schemas = {
+        // NTUPLE 0 – ScintData (Edep por step en el centellador)
+        { "ScintData", "Energy deposition per step in scintillator",
+          { {"EventID", 'I'}, {"TrackID", 'I'}, {"ParticlePDG", 'I'},
+            {"KineticEnergy_MeV", 'D'}, {"Edep_MeV", 'D'},
+            {"X_mm", 'D'}, {"Y_mm", 'D'}, {"Z_mm", 'D'},
+            {"CreatorID", 'I'}, {"Weight", 'D'} } },
 
-    G4cout << "AnalysisManager: " << analysisManager << G4endl;
-    G4cout << "Backend: " << analysisManager->GetType() << G4endl;
+        // NTUPLE 1 – ScintEvent (Edep total por evento)
+        { "ScintEvent", "Total energy per event",
+          { {"EventID", 'I'}, {"TotalEdep_MeV", 'D'}, {"Weight", 'D'} } },
 
-    // ============================================================
-    // ABRIR ARCHIVO ROOT
-    // ============================================================
-    analysisManager->OpenFile("output.root");
-    G4cout << "Archivo ROOT abierto correctamente.\n";
+        // NTUPLE 2 – SiPMData (Fotones ópticos detectados)
+        { "SiPMData", "Optical photons detected at SiPM",
+          { {"time_ns", 'D'}, {"energy_eV", 'D'},
+            {"x_mm", 'D'}, {"y_mm", 'D'}, {"z_mm", 'D'}, {"Weight", 'D'} } },
 
-    // ============================================================
-    // NTUPLE 0 – ScintData (Edep por step en el centellador)
-    // ============================================================
-    analysisManager->CreateNtuple("ScintData", "Energy deposition per step in scintillator");
+        // NTUPLE 3 – SiPMSummary (Conteo de fotones por evento; Triage:
+        // 0 completo, 1 óptica omitida, 2 abortado, ver EventTriage)
+        { "SiPMSummary", "Total photons detected per event",
+          { {"EventID", 'I'}, {"nPhotons", 'I'}, {"Weight", 'D'}, {"Triage", 'I'} } },
 
-    analysisManager->CreateNtupleIColumn("EventID");               // 0
-    analysisManager->CreateNtupleIColumn("TrackID");               // 1
-    analysisManager->CreateNtupleSColumn("Particle");              // 2
-    analysisManager->CreateNtupleDColumn("KineticEnergy_MeV");     // 3
-    analysisManager->CreateNtupleDColumn("Edep_MeV");              // 4
-    analysisManager->CreateNtupleDColumn("X_mm");                  // 5
-    analysisManager->CreateNtupleDColumn("Y_mm");                  // 6
-    analysisManager->CreateNtupleDColumn("Z_mm");                  // 7
-    analysisManager->CreateNtupleSColumn("Creator");               // 8
+        // NTUPLE 4 – OpticalGen (fotones ópticos GENERADOS; energía en eV,
+        // ParentPDG identifica si vino de Li7, alpha o e-)
+        { "OpticalGen", "Optical photons generated in scintillator",
+          { {"EventID", 'I'}, {"ParentTrackID", 'I'}, {"PhotonTrackID", 'I'},
+            {"CreatorProcessID", 'I'}, {"energy_eV", 'D'},
+            {"x_mm", 'D'}, {"y_mm", 'D'}, {"z_mm", 'D'}, {"t_ns", 'D'},
+            {"ParentPDG", 'I'}, {"Weight", 'D'} } },
 
-    analysisManager->FinishNtuple();                               // ID = 0
+        // NTUPLE 5 – ScintTrack (Edep total por track)
+        { "ScintTrack", "Total energy deposition per track in scintillator",
+          { {"EventID", 'I'}, {"TrackID", 'I'}, {"ParticlePDG", 'I'},
+            {"Edep_MeV", 'D'}, {"Weight", 'D'} } },
 
-    // ============================================================
-    // NTUPLE 1 – ScintEvent (Edep total por evento)
-    // ============================================================
-    analysisManager->CreateNtuple("ScintEvent", "Total energy per event");
+        // NTUPLE 6 – SiPMDigi (digitización de microceldas por evento)
+        { "SiPMDigi", "Digitized SiPM response per event",
+          { {"EventID", 'I'}, {"nFiredCells", 'I'}, {"Charge_pe", 'D'},
+            {"nPhotonAvalanches", 'I'}, {"nDark", 'I'}, {"nCrosstalk", 'I'},
+            {"nAfterpulse", 'I'}, {"Weight", 'D'} } },
+
+        // NTUPLE 7 – SiPMWave (parámetros de la forma de onda por evento)
+        { "SiPMWave", "SiPM waveform features per event",
+          { {"EventID", 'I'}, {"Baseline", 'D'}, {"Amplitude", 'D'},
+            {"CFDTime_ns", 'D'}, {"Charge_pe", 'D'}, {"PileUp", 'I'},
+            {"Saturated", 'I'}, {"Weight", 'D'} } },
+
+        // NTUPLE 8 – SiPMWaveSamples (muestras ADC; solo con storeSamples)
+        { "SiPMWaveSamples", "SiPM waveform ADC samples",
+          { {"EventID", 'I'}, {"Sample", 'I'}, {"ADC", 'I'} } },
+
+        // NTUPLE 9 – ChannelSum (sumas por canal de la matriz, /det/array;
+        // solo canales con señal)
+        { "ChannelSum", "Per-channel sums in the scintillator array",
+          { {"EventID", 'I'}, {"Channel", 'I'}, {"Edep_MeV", 'D'},
+            {"nPhotons", 'I'}, {"Charge_pe", 'D'}, {"Weight", 'D'} } }
+    };
+    return schemas;
+}
 
-    analysisManager->CreateNtupleIColumn("EventID");               // 0
-    analysisManager->CreateNtupleDColumn("TotalEdep_MeV");         // 1
+// =============================================================
+// Los ntuples se reservan una sola vez por hilo (maestro y workers).
+// Con el merging activado cada worker envía sus filas al maestro,
+// que escribe un único output.root.
+// =============================================================
+RunAction::RunAction() : G4UserRunAction()
+{
+    auto analysisManager = G4AnalysisManager::Instance();
+    analysisManager->SetDefaultFileType("root");
+    analysisManager->SetNtupleMerging(true);
+    analysisManager->SetVerboseLevel(0);
+    analysisManager->SetActivation(true);   // ntuples inactivos no se escriben
 
-    analysisManager->FinishNtuple();                               // ID = 1
+    // Una sola definición (NtupleSchemas) para reservar y para fusionar
+    for (const auto& schema : NtupleSchemas()) {
+        analysisManager->CreateNtuple(schema.name, schema.title);
+        for (const auto& column : schema.columns) {
+            if (column.type == 'I') analysisManager->CreateNtupleIColumn(column.name);
+            else                    analysisManager->CreateNtupleDColumn(column.name);
+        }
+        analysisManager->FinishNtuple();
+    }
 
     // ============================================================
-    // NTUPLE 2 – SiPMData (Fotones ópticos detectados)
+    // HISTOGRAMAS (/output/histograms), acumulados por hilo y sumados
+    // por el G4AnalysisManager al final del run
     // ============================================================
-    analysisManager->CreateNtuple("SiPMData", "Optical photons detected at SiPM");
+    analysisManager->CreateH1("TotalEdep", "Total energy deposited per event", 500, 0., 5., "MeV");
+    analysisManager->CreateH1("nPhotons", "Photons detected per event", 1000, 0., 10000.);
+    analysisManager->CreateH1("PhotonTime", "Photon arrival time at SiPM", 400, 0., 200., "ns");
+    // Mapa de impactos sobre la cara del SiPM (o de la matriz);
+    // BeginOfRunAction lo reajusta si /det/... cambia la geometría
+    fHitMapHalfSize = SiPMPlaneHalfSize();
+    analysisManager->CreateH2("SiPMHitMap", "Photon hit map on SiPM",
+                              100, -fHitMapHalfSize.x() / mm, fHitMapHalfSize.x() / mm,
+                              100, -fHitMapHalfSize.y() / mm, fHitMapHalfSize.y() / mm, "mm", "mm");
+
+    // Fin de creación
+    if (G4Threading::IsMasterThread())
+        G4cout << ">>> Todos los NTUPLES se crearon correctamente.\n";
+}
 
-    analysisManager->CreateNtupleDColumn("time_ns");               // 0
-    analysisManager->CreateNtupleDColumn("energy_eV");             // 1
-    analysisManager->CreateNtupleDColumn("x_mm");                  // 2
-    analysisManager->CreateNtupleDColumn("y_mm");                  // 3
-    analysisManager->CreateNtupleDColumn("z_mm");                  // 4
+RunAction::~RunAction() {}
 
-    analysisManager->FinishNtuple();                               // ID = 2
+void RunAction::BeginOfRunAction(const G4Run*)
+{
+    auto analysisManager = G4AnalysisManager::Instance();
 
     // ============================================================
-    // NTUPLE 3 – SiPMSummary (Conteo de fotones por evento)
+    // NTUPLES ACTIVOS SEGÚN EL NIVEL DE SALIDA (/output/level)
     // ============================================================
-    analysisManager->CreateNtuple("SiPMSummary", "Total photons detected per event");
+    auto output = OutputConfig::Instance();
+    analysisManager->SetNtupleActivation(NtupleId::ScintEvent,  true);
+    analysisManager->SetNtupleActivation(NtupleId::SiPMSummary, true);
+    analysisManager->SetNtupleActivation(NtupleId::ScintData,  output->Writes(OutputLevel::STEP));
+    analysisManager->SetNtupleActivation(NtupleId::SiPMData,   output->Writes(OutputLevel::PHOTON));
+    analysisManager->SetNtupleActivation(NtupleId::OpticalGen, output->Writes(OutputLevel::PHOTON));
+    analysisManager->SetNtupleActivation(NtupleId::ScintTrack, output->Writes(OutputLevel::TRACK));
+    auto sipm = SiPMConfig::Instance();
+    analysisManager->SetNtupleActivation(NtupleId::SiPMDigi,   sipm->DigitizationEnabled());
+    analysisManager->SetNtupleActivation(NtupleId::SiPMWave,   sipm->WaveformEnabled());
+    analysisManager->SetNtupleActivation(NtupleId::SiPMWaveSamples,
+                                         sipm->WaveformEnabled() && sipm->StoreWaveformSamples());
+
+    // Sumas por canal solo con la matriz
+    auto detector = static_cast<const DetectorConstruction*>(
+        G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    analysisManager->SetNtupleActivation(NtupleId::ChannelSum,
+                                         detector && detector->GetNumberOfChannels() > 1);
 
-    analysisManager->CreateNtupleIColumn("EventID");               // 0
-    analysisManager->CreateNtupleIColumn("nPhotons");              // 1
+    // Mapa de impactos: nuevo rango solo si cambió la zona de SiPMs
+    // (conserva el número de bins y un /analysis/h2/set sin cambio de geometría)
+    const G4ThreeVector hitMapHalfSize = SiPMPlaneHalfSize();
+    if (hitMapHalfSize != fHitMapHalfSize) {
+        fHitMapHalfSize = hitMapHalfSize;
+        const G4int id = HistoId::SiPMHitMap;
+        analysisManager->SetH2(id, analysisManager->GetH2Nxbins(id),
+                               -fHitMapHalfSize.x() / mm, fHitMapHalfSize.x() / mm,
+                               analysisManager->GetH2Nybins(id),
+                               -fHitMapHalfSize.y() / mm, fHitMapHalfSize.y() / mm, "mm", "mm");
+    }
 
-    analysisManager->FinishNtuple();                               // ID = 3
+    // Mapa de colección de luz (calibración o modo rápido)
+    LightCollectionMap::BeginOfRun(IsMaster());
 
+    // Perfil de steps (/profile/level)
+    Profiler::BeginOfRun(IsMaster());
+
+    // Política de fotones ópticos (/optics/photon/); después del mapa de luz
+    PhotonPolicy::BeginOfRun(IsMaster());
+
+    // Triaje de eventos (/triage/)
+    EventTriage::BeginOfRun(IsMaster());
+
+    // Espacio de fases (/phasespace/record y /phasespace/replay)
+    PhaseSpace::BeginOfRun(IsMaster());
+
+    // Histogramas activos solo en modo histograma
+    const G4bool histograms = output->FillsHistograms();
+    for (G4int id = 0; id < analysisManager->GetNofH1s(); ++id)
+        analysisManager->SetH1Activation(id, histograms);
+    for (G4int id = 0; id < analysisManager->GetNofH2s(); ++id)
+        analysisManager->SetH2Activation(id, histograms);
 
     // ============================================================
-    // NTUPLE 4 – OpticalGen (fotones ópticos GENERADOS)
+    // ABRIR ARCHIVO DE SALIDA (ROOT o columnar)
     // ============================================================
-    analysisManager->CreateNtuple("OpticalGen", "Optical photons generated in scintillator");
-
-    analysisManager->CreateNtupleIColumn("EventID");               // 0
-    analysisManager->CreateNtupleIColumn("ParentTrackID");         // 1
-    analysisManager->CreateNtupleIColumn("PhotonTrackID");         // 2
-    analysisManager->CreateNtupleSColumn("CreatorProcess");        // 3
-    
-    // CAMBIO 1: Etiqueta cambiada a eV para reflejar el cambio en ScintSD
-    analysisManager->CreateNtupleDColumn("energy_eV");             // 4
-    
-    analysisManager->CreateNtupleDColumn("x_mm");                  // 5
-    analysisManager->CreateNtupleDColumn("y_mm");                  // 6
-    analysisManager->CreateNtupleDColumn("z_mm");                  // 7
-    analysisManager->CreateNtupleDColumn("t_ns");                  // 8
-    
-    // CAMBIO 2: Nueva columna para identificar si vino de Li7, alpha o e-
-    analysisManager->CreateNtupleSColumn("ParentName");            // 9
-
-    analysisManager->FinishNtuple();                               // ID = 4
+    const G4String fileName = output->GetOutputName() + output->GetExtension();
+    const G4bool columnar = output->GetFormat() == OutputFormat::COLUMNAR;
 
-    // Fin de creación
-    G4cout << ">>> Todos los NTUPLES se crearon correctamente.\n";
+    if (columnar) {
+        // Un solo archivo: lo abre el maestro antes de que empiecen los workers
+        std::vector<G4bool> active;
+        for (std::size_t id = 0; id < NtupleSchemas().size(); ++id)
+            active.push_back(analysisManager->GetNtupleActivation(static_cast<G4int>(id)));
+        if (IsMaster())
+            ColumnarWriter::Instance()->Open(fileName, active);
+        ColumnarBuffer::Local()->Reset();
+
+        // Los histogramas siguen yendo a <salida>.root, sin ntuples
+        for (std::size_t id = 0; id < active.size(); ++id)
+            analysisManager->SetNtupleActivation(static_cast<G4int>(id), false);
+        if (histograms)
+            analysisManager->OpenFile(output->GetOutputName() + ".root");
+    }
+    else {
+        analysisManager->OpenFile(fileName);
+    }
+
+    if (IsMaster()) {
+        // Códigos de procesos deterministas antes de que empiecen los workers
+        ProcessDictionary::Instance()->RegisterProcessTable();
+
+        G4cout << "Backend: " << (columnar ? G4String("columnar") : analysisManager->GetType()) << G4endl;
+        G4cout << "Archivo " << fileName << " abierto correctamente.\n";
+    }
 }
 
 
@@ -104,12 +237,43 @@ void RunAction::EndOfRunAction(const G4Run* run)
 {
     auto analysisManager = G4AnalysisManager::Instance();
 
-    // --- Guardar archivo ROOT ---
-    analysisManager->Write();
-    analysisManager->CloseFile();
+    // --- Guardar la salida ---
+    // Columnar: cada hilo escribe sus filas pendientes; los workers terminan
+    // antes que el maestro, que cierra el archivo con el índice
+    if (OutputConfig::Instance()->GetFormat() == OutputFormat::COLUMNAR) {
+        ColumnarBuffer::Local()->Flush();
+        if (IsMaster()) ColumnarWriter::Instance()->Close();
+    }
+    if (analysisManager->IsOpenFile()) {
+        analysisManager->Write();
+        analysisManager->CloseFile();
+    }
+
+    // Fusión y guardado del mapa de luz en modo calibración
+    LightCollectionMap::EndOfRun(IsMaster());
+
+    // Fusión de los perfiles de cada hilo; el maestro imprime el ranking
+    Profiler::EndOfRun(IsMaster());
+
+    // Tabla de pérdidas de fotones ópticos por destino
+    PhotonPolicy::EndOfRun(IsMaster());
+
+    // Eventos abortados y con la óptica omitida
+    EventTriage::EndOfRun(IsMaster());
+
+    PhaseSpace::EndOfRun(IsMaster());
+
+    // Solo el maestro conoce el total de eventos de todos los hilos
+    if (!IsMaster()) return;
+
+    // Tabla de códigos de procesos usada por las columnas *ID
+    auto output = OutputConfig::Instance();
+    const G4String fileName = output->GetOutputName();
+    ProcessDictionary::Instance()->Write(fileName + "_dict.csv");
 
     G4cout << "\n=========== ESTADÍSTICAS DEL RUN ===========\n";
     G4cout << "Eventos procesados: " << run->GetNumberOfEvent() << G4endl;
-    G4cout << "Archivo ROOT guardado como: output.root\n";
+    G4cout << "Archivo de ntuples guardado como: " << fileName << output->GetExtension() << "\n";
+    G4cout << "Diccionario de procesos: " << fileName << "_dict.csv\n";
     G4cout << "=============================================\n";
 }
\ No newline at end of file
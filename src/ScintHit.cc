@@ -0,0 +1,26 @@
+#include "ScintHit.hh"
+
+#include "G4Circle.hh"
+#include "G4Colour.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VVisManager.hh"
+#include "G4VisAttributes.hh"
+
+#include <cmath>
+
+G4ThreadLocal G4Allocator<ScintHit>* ScintHitAllocator = nullptr;
+G4ThreadLocal G4Allocator<ScintTrackHit>* ScintTrackHitAllocator = nullptr;
+G4ThreadLocal G4Allocator<ScintChannelHit>* ScintChannelHitAllocator = nullptr;
+
+void ScintHit::Draw()
+{
+    auto visManager = G4VVisManager::GetConcreteInstance();
+    if (!visManager) return;
+
+    // Tamaño del marcador según la energía depositada
+    G4Circle circle(fPos);
+    circle.SetScreenSize(2. + 2.*std::log10(1. + fEdep/keV));
+    circle.SetFillStyle(G4Circle::filled);
+    circle.SetVisAttributes(G4VisAttributes(G4Colour(1., 0.5, 0.)));
+    visManager->Draw(circle);
+}
@@ -1,27 +1,60 @@
 #include "ScintSD.hh"
+#include "OutputConfig.hh"
+#include "ProcessDictionary.hh"
+#include "OpticsConfig.hh"
+#include "LightCollectionMap.hh"
+#include "PhaseSpace.hh"
+#include "DetectorConstruction.hh"
 
 #include "G4Step.hh"
 #include "G4Track.hh"
-#include "G4RunManager.hh"
-#include "G4Event.hh"
-#include "G4AnalysisManager.hh"
-#include "G4SystemOfUnits.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4SDManager.hh"
 #include "G4OpticalPhoton.hh"
+#include "G4Gamma.hh"
 #include "G4VProcess.hh"
 
 ScintSD::ScintSD(const G4String& name)
     : G4VSensitiveDetector(name)
 {
+    collectionName.insert("ScintHits");
+    collectionName.insert("ScintTrackHits");
+    collectionName.insert("OpticalGenHits");
+    collectionName.insert("ScintChannelHits");
 }
 
 ScintSD::~ScintSD() {}
 
 // =============================================================
-// Inicializa datos por evento
+// Inicializa las colecciones del evento
 // =============================================================
-void ScintSD::Initialize(G4HCofThisEvent*)
+void ScintSD::Initialize(G4HCofThisEvent* hce)
 {
-    fEdepPerTrack.clear();
+    fStepHits       = new ScintHitsCollection(SensitiveDetectorName, collectionName[0]);
+    fTrackHits      = new ScintTrackHitsCollection(SensitiveDetectorName, collectionName[1]);
+    fOpticalGenHits = new OpticalGenHitsCollection(SensitiveDetectorName, collectionName[2]);
+    fChannelHits    = new ScintChannelHitsCollection(SensitiveDetectorName, collectionName[3]);
+
+    if (fStepHCID < 0) {
+        auto sdManager = G4SDManager::GetSDMpointer();
+        fStepHCID       = sdManager->GetCollectionID(fStepHits);
+        fTrackHCID      = sdManager->GetCollectionID(fTrackHits);
+        fOpticalGenHCID = sdManager->GetCollectionID(fOpticalGenHits);
+        fChannelHCID    = sdManager->GetCollectionID(fChannelHits);
+    }
+    hce->AddHitsCollection(fStepHCID, fStepHits);
+    hce->AddHitsCollection(fTrackHCID, fTrackHits);
+    hce->AddHitsCollection(fOpticalGenHCID, fOpticalGenHits);
+    hce->AddHitsCollection(fChannelHCID, fChannelHits);
+
+    fTrackIndex.clear();
+    fChannelIndex.clear();
+
+    auto output = OutputConfig::Instance();
+    fWriteSteps   = output->Writes(OutputLevel::STEP);
+    fWritePhotons = output->Writes(OutputLevel::PHOTON);
+    fCalibrating  = OpticsConfig::Instance()->GetLightMapMode() == LightMapMode::CALIBRATE;
+    fRecordPhaseSpace = PhaseSpace::Instance()->IsRecording();
 }
 
 // =============================================================
@@ -29,50 +62,71 @@ void ScintSD::Initialize(G4HCofThisEvent*)
 // =============================================================
 G4bool ScintSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 {
-    auto analysis = G4AnalysisManager::Instance();
-
     // ------------------------------------------------------------
     // Información básica del step y del TRACK ACTUAL (El "Padre" de los fotones)
     // ------------------------------------------------------------
     const G4Track* track = step->GetTrack();
     auto pre = step->GetPreStepPoint();
 
-    // Obtenemos el nombre de la partícula que está depositando energía o generando luz.
-    // Para neutrones+Boro, aquí esperas ver: "Li7", "alpha"
-    // Para gammas interactuando, verás: "e-" (electrones secundarios)
-    G4String parentName = track->GetDefinition()->GetParticleName();
+    // Código PDG de la partícula que está depositando energía o generando luz.
+    // Para neutrones+Boro, aquí esperas ver: Li7 (1000030070), alpha (1000020040)
+    // Para gammas interactuando, verás: e- (11, electrones secundarios)
+    // Entero en lugar de G4String: sin reservas de memoria por step.
+    G4int parentPDG = track->GetDefinition()->GetPDGEncoding();
 
     G4double edep = step->GetTotalEnergyDeposit();
-    G4int eventID = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
     G4int tid     = track->GetTrackID();
 
     // ============================================================
-    // 1) REGISTRAR DEPÓSITO DE ENERGÍA (NTUPLE 0)
+    // 0) ESPACIO DE FASES: partículas cargadas y gammas que entran
+    // ============================================================
+    if (fRecordPhaseSpace && pre->GetStepStatus() == fGeomBoundary &&
+        (pre->GetCharge() != 0. || track->GetDefinition() == G4Gamma::Definition()))
+    {
+        PhaseSpace::Instance()->Record(track, pre->GetPosition(), pre->GetMomentumDirection(),
+                                       pre->GetKineticEnergy(), pre->GetGlobalTime());
+    }
+
+    // ============================================================
+    // 1) DEPÓSITO DE ENERGÍA: por track y, en nivel step, por step
     // ============================================================
     if (edep > 0.)
     {
-        fEdepPerTrack[tid] += edep;
-
-        const G4VProcess* creator = track->GetCreatorProcess();
-
-        analysis->FillNtupleIColumn(0, 0, eventID);
-        analysis->FillNtupleIColumn(0, 1, tid);
-        analysis->FillNtupleSColumn(0, 2, parentName); // Usamos la var parentName
-        analysis->FillNtupleDColumn(0, 3, pre->GetKineticEnergy() / MeV);
-        analysis->FillNtupleDColumn(0, 4, edep / MeV);
-        analysis->FillNtupleDColumn(0, 5, pre->GetPosition().x() / mm);
-        analysis->FillNtupleDColumn(0, 6, pre->GetPosition().y() / mm);
-        analysis->FillNtupleDColumn(0, 7, pre->GetPosition().z() / mm);
-        analysis->FillNtupleSColumn(0, 8,
-            creator ? creator->GetProcessName() : "primary");
-
-        analysis->AddNtupleRow(0);
+        auto it = fTrackIndex.find(tid);
+        if (it == fTrackIndex.end()) {
+            // insert() devuelve el número de entradas tras insertar
+            const std::size_t index = fTrackHits->insert(new ScintTrackHit(tid, parentPDG, track->GetWeight())) - 1;
+            it = fTrackIndex.emplace(tid, index).first;
+        }
+        (*fTrackHits)[it->second]->AddEdep(edep);
+
+        // Suma por canal: número de réplica de la celda de la matriz
+        const G4int channel = DetectorConstruction::GetChannel(pre->GetTouchable());
+        auto ch = fChannelIndex.find(channel);
+        if (ch == fChannelIndex.end()) {
+            const std::size_t index = fChannelHits->insert(new ScintChannelHit(channel)) - 1;
+            ch = fChannelIndex.emplace(channel, index).first;
+        }
+        (*fChannelHits)[ch->second]->AddEdep(edep);
+
+        if (fWriteSteps)
+        {
+            const G4VProcess* creator = track->GetCreatorProcess();
+            fStepHits->insert(new ScintHit(tid, parentPDG,
+                                           ProcessDictionary::Instance()->GetCode(creator),   // 0 = primary
+                                           pre->GetKineticEnergy(), edep, pre->GetPosition(),
+                                           track->GetWeight()));
+        }
     }
 
     // ============================================================
-    // 2) REGISTRAR FOTONES ÓPTICOS GENERADOS EN ESTE STEP (NTUPLE 4)
+    // 2) FOTONES ÓPTICOS GENERADOS EN ESTE STEP
     // ============================================================
+    if (!fWritePhotons && !fCalibrating)
+        return true;
+
     auto secondaries = step->GetSecondaryInCurrentStep();
+    auto dictionary  = ProcessDictionary::Instance();
 
     // Iteramos sobre las partículas creadas en este paso (ej. fotones ópticos)
     for (auto secTrack : *secondaries)
@@ -80,48 +134,24 @@ G4bool ScintSD::ProcessHits(G4Step* step, G4TouchableHistory*)
         // Verificamos que sea un fotón óptico
         if (secTrack->GetDefinition() == G4OpticalPhoton::OpticalPhotonDefinition())
         {
-            const G4VProcess* proc = secTrack->GetCreatorProcess();
-            G4String procName = proc ? proc->GetProcessName() : "None";
-
-            analysis->FillNtupleIColumn(4, 0, eventID);                      // EventID
-            analysis->FillNtupleIColumn(4, 1, tid);                          // Parent TrackID
-            analysis->FillNtupleIColumn(4, 2, secTrack->GetTrackID());       // Photon TrackID
-            analysis->FillNtupleSColumn(4, 3, procName);                     // Creator process
-
-            // --- CAMBIO IMPORTANTE: Unidades en eV ---
-            // Los fotones ópticos tienen energías de ~2-3 eV. 
-            // Si usas MeV, perderás precisión.
-            analysis->FillNtupleDColumn(4, 4, secTrack->GetKineticEnergy() / eV);
-
-            analysis->FillNtupleDColumn(4, 5, secTrack->GetPosition().x() / mm);
-            analysis->FillNtupleDColumn(4, 6, secTrack->GetPosition().y() / mm);
-            analysis->FillNtupleDColumn(4, 7, secTrack->GetPosition().z() / mm);
-            analysis->FillNtupleDColumn(4, 8, secTrack->GetGlobalTime() / ns);
-            
-            // --- NUEVO CAMBIO: Guardar quién generó el fotón ---
-            // Esto guardará "Li7", "alpha", o "e-" en la columna 9
-            analysis->FillNtupleSColumn(4, 9, parentName);
-
-            analysis->AddNtupleRow(4);
+            // Calibración del mapa de luz: fotones nacidos por vóxel
+            if (fCalibrating)
+                LightCollectionMap::Local()->AddBorn(secTrack->GetPosition());
+
+            if (!fWritePhotons)
+                continue;
+
+            // Los fotones ópticos tienen energías de ~2-3 eV: el ntuple las guarda en eV.
+            // El PDG del padre (Li7, alpha, e-) identifica quién generó el fotón.
+            fOpticalGenHits->insert(new OpticalGenHit(tid, secTrack->GetTrackID(),
+                                                      dictionary->GetCode(secTrack->GetCreatorProcess()),
+                                                      parentPDG,
+                                                      secTrack->GetKineticEnergy(),
+                                                      secTrack->GetGlobalTime(),
+                                                      secTrack->GetPosition(),
+                                                      secTrack->GetWeight()));
         }
     }
 
     return true;
 }
-
-// =============================================================
-// EndOfEvent: energía total del evento (NTUPLE 1)
-// =============================================================
-void ScintSD::EndOfEvent(G4HCofThisEvent*)
-{
-    auto analysis = G4AnalysisManager::Instance();
-    G4int eventID = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-
-    G4double totalE = 0.;
-    for (auto& kv : fEdepPerTrack)
-        totalE += kv.second;
-
-    analysis->FillNtupleIColumn(1, 0, eventID);
-    analysis->FillNtupleDColumn(1, 1, totalE / MeV);
-    analysis->AddNtupleRow(1);
-}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "SiPMConfig.hh"
+#include "OpticsConfig.hh"
+#include "MasterCommand.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4ApplicationState.hh"
+#include "G4SystemOfUnits.hh"
+
+SiPMConfig* SiPMConfig::Instance()
+{
+    // Debe crearse primero en el maestro para registrar sus comandos
+    static SiPMConfig* instance = new SiPMConfig();
+    return instance;
+}
+
+SiPMConfig::SiPMConfig()
+: fCellPitch(50.*um),
+  fRecoveryTime(20.*ns),
+  fAfterpulseTime(50.*ns),
+  fDarkRate(500.*kilohertz),
+  fGateStart(0.*ns),
+  fGateWidth(500.*ns),
+  fSamplingRate(500.*megahertz),
+  fRecordLength(2000.*ns),
+  fPreTrigger(100.*ns),
+  fPulseRise(1.*ns),
+  fPulseDecay(40.*ns),
+  fCFDDelay(4.*ns),
+  fChargePreGate(20.*ns),
+  fChargeGate(1000.*ns)
+{
+    fMessenger = new G4GenericMessenger(this, "/sipm/", "Parámetros del SiPM");
+
+    auto& pdeCmd = fMessenger->DeclareProperty("pde", fPDE,
+        "Photo Detection Efficiency del SiPM (0-1).");
+    pdeCmd.SetParameterName("pde", false);
+    pdeCmd.SetRange("pde>=0. && pde<=1.");
+    MasterOnly(pdeCmd);
+
+    auto& cullCmd = fMessenger->DeclareProperty("cullAtBirth", fCullAtBirth,
+        "Aplica el PDE al crear cada fotón óptico (se matan 1-PDE antes de seguirlos); "
+        "el SD cuenta entonces todas las llegadas.");
+    cullCmd.SetParameterName("cull", true);
+    cullCmd.SetDefaultValue("true");
+    MasterOnly(cullCmd);
+
+    // ------------------------------------------------------------
+    // Digitización de microceldas
+    // ------------------------------------------------------------
+    fDigiMessenger = new G4GenericMessenger(this, "/sipm/digi/",
+                                            "Digitización del SiPM a nivel de microcelda");
+
+    auto& enableCmd = fDigiMessenger->DeclareProperty("enable", fDigitize,
+        "Digitiza cada evento y escribe el ntuple SiPMDigi.");
+    enableCmd.SetParameterName("enable", true);
+    enableCmd.SetDefaultValue("true");
+    MasterOnly(enableCmd);
+
+    auto& pitchCmd = fDigiMessenger->DeclarePropertyWithUnit("cellPitch", "um", fCellPitch,
+        "Paso de la malla de microceldas sobre la cara del SiPM.");
+    pitchCmd.SetParameterName("pitch", false);
+    pitchCmd.SetRange("pitch>0.");
+    MasterOnly(pitchCmd);
+
+    MasterOnly(fDigiMessenger->DeclarePropertyWithUnit("recoveryTime", "ns", fRecoveryTime,
+        "Constante de recuperación: una celda que redispara aporta 1-exp(-dt/tau)."));
+
+    auto& xtCmd = fDigiMessenger->DeclareProperty("crosstalk", fCrosstalk,
+        "Probabilidad de crosstalk óptico a una celda vecina por avalancha.");
+    xtCmd.SetParameterName("p", false);
+    xtCmd.SetRange("p>=0. && p<1.");
+    MasterOnly(xtCmd);
+
+    auto& apCmd = fDigiMessenger->DeclareProperty("afterpulse", fAfterpulse,
+        "Probabilidad de afterpulse por avalancha.");
+    apCmd.SetParameterName("p", false);
+    apCmd.SetRange("p>=0. && p<1.");
+    MasterOnly(apCmd);
+
+    MasterOnly(fDigiMessenger->DeclarePropertyWithUnit("afterpulseTime", "ns", fAfterpulseTime,
+        "Retardo medio (exponencial) de los afterpulses."));
+
+    MasterOnly(fDigiMessenger->DeclarePropertyWithUnit("darkRate", "kHz", fDarkRate,
+        "Tasa de cuentas oscuras de todo el dispositivo."));
+
+    MasterOnly(fDigiMessenger->DeclarePropertyWithUnit("gateStart", "ns", fGateStart,
+        "Inicio de la ventana de integración (tiempo global)."));
+
+    MasterOnly(fDigiMessenger->DeclarePropertyWithUnit("gateWidth", "ns", fGateWidth,
+        "Ancho de la ventana de integración."));
+
+    // ------------------------------------------------------------
+    // Forma de onda y procesado tipo digitalizador
+    // ------------------------------------------------------------
+    fWaveMessenger = new G4GenericMessenger(this, "/sipm/wave/",
+                                            "Forma de onda muestreada del SiPM y su procesado");
+
+    auto& waveCmd = fWaveMessenger->DeclareProperty("enable", fWaveform,
+        "Sintetiza la forma de onda de cada evento y escribe el ntuple SiPMWave "
+        "(línea base, amplitud, tiempo CFD, carga, pile-up).");
+    waveCmd.SetParameterName("enable", true);
+    waveCmd.SetDefaultValue("true");
+    MasterOnly(waveCmd);
+
+    auto& storeCmd = fWaveMessenger->DeclareProperty("storeSamples", fWaveStoreSamples,
+        "Guarda además todas las muestras ADC (ntuple SiPMWaveSamples, una fila por muestra).");
+    storeCmd.SetParameterName("store", true);
+    storeCmd.SetDefaultValue("true");
+    MasterOnly(storeCmd);
+
+    auto& rateCmd = fWaveMessenger->DeclarePropertyWithUnit("samplingRate", "MHz", fSamplingRate,
+        "Frecuencia de muestreo del digitalizador.");
+    rateCmd.SetParameterName("rate", false);
+    rateCmd.SetRange("rate>0.");
+    MasterOnly(rateCmd);
+
+    MasterOnly(fWaveMessenger->DeclarePropertyWithUnit("recordLength", "ns", fRecordLength,
+        "Longitud de la ventana de adquisición."));
+    MasterOnly(fWaveMessenger->DeclarePropertyWithUnit("preTrigger", "ns", fPreTrigger,
+        "Muestras antes del primer pulso (línea base)."));
+    MasterOnly(fWaveMessenger->DeclarePropertyWithUnit("riseTime", "ns", fPulseRise,
+        "Constante de subida del pulso de 1 p.e."));
+    MasterOnly(fWaveMessenger->DeclarePropertyWithUnit("decayTime", "ns", fPulseDecay,
+        "Constante de caída del pulso de 1 p.e."));
+
+    MasterOnly(fWaveMessenger->DeclareProperty("gain", fADCGain,
+        "Amplitud de pico de 1 p.e. en cuentas ADC."));
+    MasterOnly(fWaveMessenger->DeclareProperty("noise", fADCNoise,
+        "Ruido electrónico gaussiano por muestra (cuentas ADC RMS)."));
+
+    auto& bitsCmd = fWaveMessenger->DeclareProperty("adcBits", fADCBits,
+        "Resolución del ADC (bits).");
+    bitsCmd.SetParameterName("bits", false);
+    bitsCmd.SetRange("bits>=8 && bits<=16");
+    MasterOnly(bitsCmd);
+
+    MasterOnly(fWaveMessenger->DeclareProperty("baseline", fADCBaseline,
+        "Línea base del ADC (cuentas)."));
+    MasterOnly(fWaveMessenger->DeclareProperty("threshold", fTriggerThreshold,
+        "Umbral de disparo sobre la línea base (p.e.)."));
+
+    auto& fractionCmd = fWaveMessenger->DeclareProperty("cfdFraction", fCFDFraction,
+        "Fracción del discriminador de fracción constante.");
+    fractionCmd.SetParameterName("f", false);
+    fractionCmd.SetRange("f>0. && f<1.");
+    MasterOnly(fractionCmd);
+
+    MasterOnly(fWaveMessenger->DeclarePropertyWithUnit("cfdDelay", "ns", fCFDDelay,
+        "Retardo del CFD."));
+    MasterOnly(fWaveMessenger->DeclarePropertyWithUnit("preGate", "ns", fChargePreGate,
+        "Inicio de la integración de carga antes del disparo."));
+    MasterOnly(fWaveMessenger->DeclarePropertyWithUnit("gate", "ns", fChargeGate,
+        "Ancho de la integración de carga (puerta larga; ~1 us para CsI)."));
+    MasterOnly(fWaveMessenger->DeclareProperty("pileUpFraction", fPileUpFraction,
+        "Un segundo flanco tras el pico mayor que esta fracción de la amplitud marca pile-up."));
+}
+
+G4bool SiPMConfig::CullAtBirth() const
+{
+    return fCullAtBirth
+        && OpticsConfig::Instance()->GetLightMapMode() != LightMapMode::CALIBRATE;
+}
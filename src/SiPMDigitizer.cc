@@ -0,0 +1,186 @@
+#include "SiPMDigitizer.hh"
+#include "SiPMConfig.hh"
+
+#include "G4Box.hh"
+#include "G4LogicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4PVReplica.hh"
+#include "G4Poisson.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+G4bool SiPMDigitizer::Configure()
+{
+    auto sipm = G4PhysicalVolumeStore::GetInstance()->GetVolume("SiPM", false);
+    auto box = sipm ? dynamic_cast<G4Box*>(sipm->GetLogicalVolume()->GetSolid()) : nullptr;
+    if (!box) {
+        G4cerr << "SiPMDigitizer: no se encontró el volumen SiPM" << G4endl;
+        return false;
+    }
+
+    auto config = SiPMConfig::Instance();
+
+    fPitch = config->GetCellPitch();
+    fCellsX = std::max(1, static_cast<G4int>(2*box->GetXHalfLength() / fPitch));
+    fCellsY = std::max(1, static_cast<G4int>(2*box->GetYHalfLength() / fPitch));
+
+    // Celdas centradas sobre la cara del SiPM (en la matriz, relativa
+    // al centro de su celda)
+    const G4ThreeVector center = sipm->GetTranslation();
+    fX0 = center.x() - 0.5 * fCellsX * fPitch;
+    fY0 = center.y() - 0.5 * fCellsY * fPitch;
+
+    // Matriz (/det/array): réplicas ArrayColumn (X) y ArrayCell (Y)
+    auto store = G4PhysicalVolumeStore::GetInstance();
+    auto array  = store->GetVolume("ScintArray", false);
+    auto column = store->GetVolume("ArrayColumn", false);
+    auto cell   = store->GetVolume("ArrayCell", false);
+    fArrayNy = 0;
+    if (array && column && cell) {
+        EAxis axis;
+        G4int nx = 0;
+        G4double offset = 0.;
+        G4bool consuming = false;
+        column->GetReplicationData(axis, nx, fArrayPitchX, offset, consuming);
+        cell->GetReplicationData(axis, fArrayNy, fArrayPitchY, offset, consuming);
+        fArrayX0 = array->GetTranslation().x() - 0.5 * nx * fArrayPitchX;
+        fArrayY0 = array->GetTranslation().y() - 0.5 * fArrayNy * fArrayPitchY;
+    }
+
+    fRecovery      = config->GetRecoveryTime();
+    fCrosstalk     = config->GetCrosstalkProbability();
+    fAfterpulse    = config->GetAfterpulseProbability();
+    fAfterpulseTau = config->GetAfterpulseTime();
+    fDarkRate      = config->GetDarkRate();
+    fGateStart     = config->GetGateStart();
+    fGateEnd       = fGateStart + config->GetGateWidth();
+
+    const std::size_t nCells = static_cast<std::size_t>(fCellsX) * fCellsY;
+    fLastFire.assign(nCells, 0.);
+    fStamp.assign(nCells, 0);
+    fEpoch = 0;
+
+    return true;
+}
+
+void SiPMDigitizer::BeginEvent()
+{
+    fPulseTime.clear();
+    fPulseAmplitude.clear();
+}
+
+SiPMDigi SiPMDigitizer::Digitize(const std::vector<G4double>& time,
+                                 const std::vector<G4double>& x,
+                                 const std::vector<G4double>& y,
+                                 G4int channel)
+{
+    SiPMDigi digi;
+    if (fCellsX == 0) return digi;
+
+    // Nuevo evento o canal: todas las celdas quedan "frías" sin tocar la malla
+    if (++fEpoch == 0) {
+        std::fill(fStamp.begin(), fStamp.end(), 0);
+        fEpoch = 1;
+    }
+    fQueue.clear();
+
+    // Centro de la celda del canal en la matriz
+    G4double offsetX = 0.;
+    G4double offsetY = 0.;
+    if (fArrayNy > 0) {
+        offsetX = fArrayX0 + (channel / fArrayNy + 0.5) * fArrayPitchX;
+        offsetY = fArrayY0 + (channel % fArrayNy + 0.5) * fArrayPitchY;
+    }
+
+    // ------------------------------------------------------------
+    // Avalanchas primarias: fotones dentro de la ventana
+    // ------------------------------------------------------------
+    for (std::size_t i = 0; i < time.size(); ++i) {
+        if (time[i] < fGateStart || time[i] >= fGateEnd) continue;
+
+        const G4int ix = static_cast<G4int>((x[i] - offsetX - fX0) / fPitch);
+        const G4int iy = static_cast<G4int>((y[i] - offsetY - fY0) / fPitch);
+        if (ix < 0 || ix >= fCellsX || iy < 0 || iy >= fCellsY) continue;
+
+        Push(time[i], iy * fCellsX + ix, Origin::PHOTON);
+    }
+
+    // ------------------------------------------------------------
+    // Cuentas oscuras térmicas: Poisson en toda la ventana
+    // ------------------------------------------------------------
+    const G4int nCells = fCellsX * fCellsY;
+    const G4long nDark = G4Poisson(fDarkRate * (fGateEnd - fGateStart));
+    for (G4long i = 0; i < nDark; ++i) {
+        const G4double t = fGateStart + G4UniformRand() * (fGateEnd - fGateStart);
+        const G4int cell = std::min(static_cast<G4int>(G4UniformRand() * nCells), nCells - 1);
+        Push(t, cell, Origin::DARK);
+    }
+
+    // ------------------------------------------------------------
+    // Procesado en orden temporal
+    // ------------------------------------------------------------
+    while (!fQueue.empty()) {
+        std::pop_heap(fQueue.begin(), fQueue.end());
+        const Avalanche av = fQueue.back();
+        fQueue.pop_back();
+
+        // Amplitud según la recuperación de la celda
+        G4double amplitude = 1.;
+        if (fStamp[av.cell] == fEpoch) {
+            const G4double dt = av.time - fLastFire[av.cell];
+            amplitude = (fRecovery > 0.) ? 1. - std::exp(-dt / fRecovery) : 1.;
+        }
+        else {
+            fStamp[av.cell] = fEpoch;
+            digi.nFiredCells++;
+        }
+        fLastFire[av.cell] = av.time;
+        digi.charge += amplitude;
+        fPulseTime.push_back(av.time);
+        fPulseAmplitude.push_back(amplitude);
+
+        switch (av.origin) {
+            case Origin::PHOTON:     digi.nPhotons++;    break;
+            case Origin::DARK:       digi.nDark++;       break;
+            case Origin::CROSSTALK:  digi.nCrosstalk++;  break;
+            case Origin::AFTERPULSE: digi.nAfterpulse++; break;
+        }
+
+        // Crosstalk óptico inmediato a una celda vecina (en cascada),
+        // proporcional a la carga de la avalancha
+        if (G4UniformRand() < fCrosstalk * amplitude) {
+            const G4int neighbour = RandomNeighbour(av.cell);
+            if (neighbour >= 0) Push(av.time, neighbour, Origin::CROSSTALK);
+        }
+
+        // Afterpulse retardado en la misma celda
+        if (G4UniformRand() < fAfterpulse * amplitude) {
+            const G4double t = av.time + CLHEP::RandExponential::shoot(fAfterpulseTau);
+            if (t < fGateEnd) Push(t, av.cell, Origin::AFTERPULSE);
+        }
+    }
+
+    return digi;
+}
+
+void SiPMDigitizer::Push(G4double time, G4int cell, Origin origin)
+{
+    fQueue.push_back({ time, cell, origin });
+    std::push_heap(fQueue.begin(), fQueue.end());
+}
+
+G4int SiPMDigitizer::RandomNeighbour(G4int cell) const
+{
+    const G4int ix = cell % fCellsX;
+    const G4int iy = cell / fCellsX;
+
+    switch (static_cast<G4int>(G4UniformRand() * 4.)) {
+        case 0:  return (ix > 0)           ? cell - 1       : -1;
+        case 1:  return (ix < fCellsX - 1) ? cell + 1       : -1;
+        case 2:  return (iy > 0)           ? cell - fCellsX : -1;
+        default: return (iy < fCellsY - 1) ? cell + fCellsX : -1;
+    }
+}
@@ -0,0 +1,20 @@
+#include "SiPMHit.hh"
+
+#include "G4Circle.hh"
+#include "G4Colour.hh"
+#include "G4VVisManager.hh"
+#include "G4VisAttributes.hh"
+
+G4ThreadLocal G4Allocator<SiPMHit>* SiPMHitAllocator = nullptr;
+
+void SiPMHit::Draw()
+{
+    auto visManager = G4VVisManager::GetConcreteInstance();
+    if (!visManager) return;
+
+    G4Circle circle(fPos);
+    circle.SetScreenSize(2.);
+    circle.SetFillStyle(G4Circle::filled);
+    circle.SetVisAttributes(G4VisAttributes(G4Colour(0., 1., 0.)));
+    visManager->Draw(circle);
+}
@@ -0,0 +1,210 @@
+#include "SiPMWaveform.hh"
+#include "SiPMConfig.hh"
+
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// El pulso de 1 p.e. se corta cuando cae por debajo de esta fracción del pico
+constexpr G4double kKernelCutoff = 1.e-3;
+
+// out[i] += a * kernel[i]: bucle plano sin alias, vectorizable
+inline void Axpy(float* __restrict out, const float* __restrict kernel, std::size_t n, float a)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] += a * kernel[i];
+}
+
+}
+
+// =============================================================
+// Configuración al inicio de cada run
+// =============================================================
+void SiPMWaveform::Configure()
+{
+    auto config = SiPMConfig::Instance();
+
+    fPeriod = 1. / config->GetSamplingRate();
+    fNSamples = std::max<std::size_t>(1, static_cast<std::size_t>(config->GetRecordLength() / fPeriod));
+    fNPreTrigger = std::min(fNSamples - 1, static_cast<std::size_t>(config->GetPreTrigger() / fPeriod));
+
+    fGain = config->GetADCGain();
+    fNoise = config->GetADCNoise();
+    fBaseline = config->GetADCBaseline();
+    fADCMax = (1 << config->GetADCBits()) - 1;
+
+    fThreshold = config->GetTriggerThreshold() * fGain;
+    fCFDFraction = config->GetCFDFraction();
+    fCFDDelay = std::max<std::size_t>(1, static_cast<std::size_t>(std::lround(config->GetCFDDelay() / fPeriod)));
+    fPreGate = static_cast<std::size_t>(config->GetChargePreGate() / fPeriod);
+    fGate = std::max<std::size_t>(1, static_cast<std::size_t>(config->GetChargeGate() / fPeriod));
+    fPileUpFraction = config->GetPileUpFraction();
+
+    // ------------------------------------------------------------
+    // Pulso de 1 p.e.: diferencia de exponenciales normalizada al pico
+    // ------------------------------------------------------------
+    const G4double rise = std::max(config->GetPulseRiseTime(), 1.e-3 * fPeriod);
+    const G4double decay = std::max(config->GetPulseDecayTime(), 1.01 * rise);
+    const G4double tPeak = rise * decay / (decay - rise) * std::log(decay / rise);
+    const G4double peak = std::exp(-tPeak / decay) - std::exp(-tPeak / rise);
+
+    fKernel.clear();
+    fKernelArea = 0.;
+    for (std::size_t k = 0; k < fNSamples; ++k) {
+        const G4double t = k * fPeriod;
+        const G4double value = (std::exp(-t / decay) - std::exp(-t / rise)) / peak;
+        if (t > tPeak && value < kKernelCutoff) break;
+        fKernel.push_back(static_cast<float>(value));
+        fKernelArea += value;
+    }
+
+    fDeposit.assign(fNSamples + 1, 0.f);
+    fSignal.assign(fNSamples, 0.f);
+    fADC.assign(fNSamples, 0);
+}
+
+SiPMWaveFeatures SiPMWaveform::Process(const std::vector<G4double>& time,
+                                       const std::vector<G4double>& amplitude)
+{
+    Synthesize(time, amplitude);
+    return Analyze();
+}
+
+// =============================================================
+// Síntesis: depósitos por muestra, convolución, ruido y ADC
+// =============================================================
+void SiPMWaveform::Synthesize(const std::vector<G4double>& time,
+                              const std::vector<G4double>& amplitude)
+{
+    std::fill(fDeposit.begin(), fDeposit.end(), 0.f);
+    std::fill(fSignal.begin(), fSignal.end(), 0.f);
+
+    // Auto-disparo: la ventana empieza preTrigger antes del primer pulso
+    const G4double first = time.empty() ? 0. : *std::min_element(time.begin(), time.end());
+    fStartTime = first - fNPreTrigger * fPeriod;
+
+    // Reparto lineal entre las dos muestras vecinas (conserva el
+    // instante con resolución mejor que el periodo)
+    for (std::size_t i = 0; i < time.size(); ++i) {
+        const G4double position = (time[i] - fStartTime) / fPeriod;
+        if (position < 0. || position >= fNSamples) continue;
+
+        const std::size_t sample = static_cast<std::size_t>(position);
+        const G4double fraction = position - sample;
+        fDeposit[sample]     += static_cast<float>(amplitude[i] * (1. - fraction));
+        fDeposit[sample + 1] += static_cast<float>(amplitude[i] * fraction);
+    }
+
+    // Convolución con el pulso de 1 p.e., solo donde hay carga
+    const float gain = static_cast<float>(fGain);
+    for (std::size_t i = 0; i < fNSamples; ++i) {
+        if (fDeposit[i] == 0.f) continue;
+        const std::size_t n = std::min(fKernel.size(), fNSamples - i);
+        Axpy(fSignal.data() + i, fKernel.data(), n, gain * fDeposit[i]);
+    }
+
+    // Ruido electrónico y cuantización
+    for (std::size_t i = 0; i < fNSamples; ++i) {
+        G4double value = fBaseline + fSignal[i];
+        if (fNoise > 0.) value += CLHEP::RandGaussQ::shoot(0., fNoise);
+        const auto count = static_cast<std::int32_t>(std::lround(value));
+        fADC[i] = std::clamp<std::int32_t>(count, 0, fADCMax);
+    }
+}
+
+// =============================================================
+// Procesado tipo digitalizador
+// =============================================================
+SiPMWaveFeatures SiPMWaveform::Analyze() const
+{
+    SiPMWaveFeatures features;
+
+    // Línea base: media del pre-disparo, sin las dos últimas muestras
+    // (el primer pulso puede empezar a subir en ellas)
+    const std::size_t nBase = std::max<std::size_t>(1, fNPreTrigger > 2 ? fNPreTrigger - 2 : 1);
+    G4double sum = 0.;
+    for (std::size_t i = 0; i < nBase; ++i) sum += fADC[i];
+    features.baseline = sum / nBase;
+
+    auto signal = [&](std::size_t i) { return fADC[i] - features.baseline; };
+
+    for (const auto count : fADC) {
+        if (count == 0 || count == fADCMax) {
+            features.saturated = true;
+            break;
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Disparo y puerta
+    // ------------------------------------------------------------
+    std::size_t trigger = fNPreTrigger > 0 ? fNPreTrigger - 1 : 0;
+    while (trigger < fNSamples && signal(trigger) <= fThreshold) ++trigger;
+    const G4bool triggered = trigger < fNSamples;
+    if (!triggered) trigger = fNPreTrigger;
+
+    const std::size_t gateBegin = trigger > fPreGate ? trigger - fPreGate : 0;
+    const std::size_t gateEnd = std::min(fNSamples, trigger + fGate);
+
+    // Carga (integral en unidades del área de 1 p.e.) y pico en la puerta
+    G4double area = 0.;
+    std::size_t peak = trigger;
+    for (std::size_t i = gateBegin; i < gateEnd; ++i) {
+        area += signal(i);
+        if (signal(i) > signal(peak)) peak = i;
+    }
+    features.charge = area / (fGain * fKernelArea);
+
+    if (!triggered) return features;
+    features.amplitude = signal(peak);
+
+    // ------------------------------------------------------------
+    // CFD: c[i] = s[i - D] - f s[i]; cruce por cero de - a + tras el
+    // disparo, interpolado entre muestras
+    // ------------------------------------------------------------
+    auto cfd = [&](std::size_t i) {
+        const G4double delayed = (i >= fCFDDelay) ? signal(i - fCFDDelay) : 0.;
+        return delayed - fCFDFraction * signal(i);
+    };
+
+    const std::size_t cfdEnd = std::min(fNSamples, peak + fCFDDelay + 1);
+    for (std::size_t i = trigger + 1; i < cfdEnd; ++i) {
+        const G4double before = cfd(i - 1);
+        const G4double after = cfd(i);
+        if (before < 0. && after >= 0.) {
+            const G4double crossing = (i - 1) + before / (before - after);
+            features.cfdTime = fStartTime + crossing * fPeriod;
+            break;
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Pile-up: dentro de la puerta, la señal baja más de un escalón
+    // desde su máximo y vuelve a subir más de un escalón desde el
+    // mínimo siguiente. Escalón: pileUpFraction × amplitud, nunca por
+    // debajo del umbral más el ruido
+    // ------------------------------------------------------------
+    const G4double step = std::max(fPileUpFraction * features.amplitude, fThreshold) + 5. * fNoise;
+    G4double maximum = signal(trigger);
+    G4double minimum = maximum;
+    G4bool falling = false;
+    for (std::size_t i = trigger + 1; i < gateEnd && !features.pileUp; ++i) {
+        const G4double value = signal(i);
+        if (!falling) {
+            maximum = std::max(maximum, value);
+            if (value < maximum - step) {
+                falling = true;
+                minimum = value;
+            }
+        }
+        else {
+            minimum = std::min(minimum, value);
+            features.pileUp = value > minimum + step;
+        }
+    }
+
+    return features;
+}
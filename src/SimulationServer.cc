@@ -0,0 +1,472 @@
+#include "SimulationServer.hh"
+#include "OutputConfig.hh"
+
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+#include "Randomize.hh"
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+G4double Seconds(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<G4double>(end - begin).count();
+}
+
+std::string Trim(const std::string& text)
+{
+    const std::size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    const std::size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::string Fixed(G4double value, G4int precision = 3)
+{
+    char text[64];
+    std::snprintf(text, sizeof(text), "%.*f", precision, value);
+    return text;
+}
+
+}
+
+SimulationServer::SimulationServer(const G4String& endpoint, G4int maxJobs, long baseSeed)
+    : fEndpoint(endpoint),
+      fMaxJobs(maxJobs > 0 ? maxJobs : 1),
+      fBaseSeed(baseSeed),
+      fStdin(endpoint == "-")
+{}
+
+SimulationServer::~SimulationServer()
+{
+    Close();
+}
+
+// =============================================================
+// Socket UNIX o stdin/stdout
+// =============================================================
+G4bool SimulationServer::Open()
+{
+    if (fStdin) {
+        Connection connection;
+        connection.in = STDIN_FILENO;
+        connection.out = STDOUT_FILENO;
+        connection.open = true;
+        fConnections.push_back(connection);
+        Send(0, "READY jobs=" + std::to_string(fMaxJobs));
+        return true;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (fEndpoint.size() >= sizeof(address.sun_path)) {
+        G4cerr << "SimulationServer: ruta del socket demasiado larga: " << fEndpoint << G4endl;
+        return false;
+    }
+    std::strncpy(address.sun_path, fEndpoint.c_str(), sizeof(address.sun_path) - 1);
+
+    fListen = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fListen < 0) {
+        G4cerr << "SimulationServer: no se pudo crear el socket" << G4endl;
+        return false;
+    }
+
+    // Un socket de una ejecución anterior impediría el bind
+    unlink(fEndpoint.c_str());
+    if (bind(fListen, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(fListen, 16) != 0) {
+        G4cerr << "SimulationServer: no se pudo escuchar en " << fEndpoint
+               << ": " << std::strerror(errno) << G4endl;
+        close(fListen);
+        fListen = -1;
+        return false;
+    }
+
+    G4cout << "Servidor de simulación en " << fEndpoint << " (" << fMaxJobs
+           << " trabajos simultáneos)" << G4endl;
+    return true;
+}
+
+void SimulationServer::Close()
+{
+    if (fListen >= 0) {
+        close(fListen);
+        fListen = -1;
+        unlink(fEndpoint.c_str());
+    }
+    for (std::size_t i = 0; i < fConnections.size(); ++i) {
+        if (fConnections[i].open && !fStdin) close(fConnections[i].in);
+        fConnections[i].open = false;
+    }
+}
+
+// =============================================================
+// Bucle del servidor
+// =============================================================
+G4bool SimulationServer::Serve()
+{
+    if (!Open()) {
+        fOk = false;
+        return false;
+    }
+
+    // Un cliente que cierra antes de leer no debe terminar el servidor
+    std::signal(SIGPIPE, SIG_IGN);
+
+    while (true) {
+        if (StartJobs()) return true;
+        if (fShutdown && fQueue.empty() && fRunning.empty()) break;
+
+        // Escucha, conexiones abiertas y tuberías de los hijos, en ese orden
+        std::vector<pollfd> fds;
+        std::vector<std::pair<char, std::size_t>> owners;
+        if (fListen >= 0 && !fShutdown) {
+            fds.push_back({ fListen, POLLIN, 0 });
+            owners.emplace_back('l', 0);
+        }
+        for (std::size_t i = 0; i < fConnections.size(); ++i) {
+            if (!fConnections[i].open || !fConnections[i].reading) continue;
+            fds.push_back({ fConnections[i].in, POLLIN, 0 });
+            owners.emplace_back('c', i);
+        }
+        for (std::size_t i = 0; i < fRunning.size(); ++i) {
+            fds.push_back({ fRunning[i].pipe, POLLIN, 0 });
+            owners.emplace_back('r', i);
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            G4cerr << "SimulationServer: poll() falló: " << std::strerror(errno) << G4endl;
+            fOk = false;
+            break;
+        }
+
+        // En orden inverso: Finish borra su entrada de fRunning
+        for (std::size_t k = fds.size(); k-- > 0;) {
+            if (!fds[k].revents) continue;
+            switch (owners[k].first) {
+                case 'l': Accept(); break;
+                case 'c': Read(owners[k].second); break;
+                case 'r': Finish(owners[k].second); break;
+            }
+        }
+    }
+
+    Close();
+    return false;
+}
+
+void SimulationServer::Accept()
+{
+    const G4int fd = accept(fListen, nullptr, nullptr);
+    if (fd < 0) return;
+
+    Connection connection;
+    connection.in = fd;
+    connection.out = fd;
+    connection.open = true;
+    fConnections.push_back(connection);
+    Send(static_cast<G4int>(fConnections.size() - 1), "READY jobs=" + std::to_string(fMaxJobs));
+}
+
+void SimulationServer::Read(std::size_t index)
+{
+    char buffer[4096];
+    const ssize_t n = read(fConnections[index].in, buffer, sizeof(buffer));
+    if (n <= 0) {
+        // Fin de stdin: equivale a shutdown; la salida sigue abierta para
+        // los DONE de lo que queda en cola y en marcha
+        if (fStdin) {
+            fConnections[index].reading = false;
+            fShutdown = true;
+        }
+        else CloseConnection(index);
+        return;
+    }
+    fConnections[index].buffer.append(buffer, static_cast<std::size_t>(n));
+
+    std::size_t newline;
+    while (fConnections[index].open &&
+           (newline = fConnections[index].buffer.find('\n')) != std::string::npos) {
+        const std::string line = fConnections[index].buffer.substr(0, newline);
+        fConnections[index].buffer.erase(0, newline + 1);
+        HandleLine(index, line);
+    }
+}
+
+void SimulationServer::CloseConnection(std::size_t index)
+{
+    auto& connection = fConnections[index];
+    if (!connection.open) return;
+    if (!fStdin) close(connection.in);
+    connection.open = false;
+
+    // Los trabajos en cola de esta conexión ya no tienen a quién responder;
+    // los que están en marcha terminan igual (su salida queda en disco)
+    for (auto it = fQueue.begin(); it != fQueue.end();) {
+        if (it->connection == static_cast<G4int>(index)) it = fQueue.erase(it);
+        else ++it;
+    }
+    for (auto& running : fRunning) {
+        if (running.job.connection == static_cast<G4int>(index)) running.job.connection = -1;
+    }
+}
+
+void SimulationServer::Send(G4int connection, const std::string& line)
+{
+    if (connection < 0 || !fConnections[connection].open) return;
+
+    const std::string message = line + "\n";
+    std::size_t written = 0;
+    while (written < message.size()) {
+        const ssize_t n = write(fConnections[connection].out, message.data() + written,
+                                message.size() - written);
+        if (n <= 0) return;
+        written += static_cast<std::size_t>(n);
+    }
+}
+
+// =============================================================
+// Protocolo
+// =============================================================
+void SimulationServer::HandleLine(std::size_t index, const std::string& raw)
+{
+    const std::string line = Trim(raw);
+    if (line.empty() || line[0] == '#') return;
+
+    std::istringstream is(line);
+    std::string keyword;
+    is >> keyword;
+
+    const G4int connection = static_cast<G4int>(index);
+    auto& client = fConnections[index];
+
+    if (keyword == "status") {
+        Send(connection, "STATUS queued=" + std::to_string(fQueue.size()) +
+                         " running=" + std::to_string(fRunning.size()) +
+                         " done=" + std::to_string(fDone));
+        return;
+    }
+    if (keyword == "shutdown") {
+        fShutdown = true;
+        Send(connection, "SHUTDOWN pending=" + std::to_string(fQueue.size() + fRunning.size()));
+        return;
+    }
+
+    if (keyword == "end") {
+        Job job = client.pending;
+        client.pending = Job();
+        client.inJob = false;
+
+        if (job.commands.empty()) {
+            Send(connection, "ERROR trabajo sin comandos");
+            return;
+        }
+        if (fShutdown) {
+            Send(connection, "ERROR el servidor está terminando");
+            return;
+        }
+        job.id = fNextId++;
+        job.connection = connection;
+        job.queued = Clock::now();
+        fQueue.push_back(job);
+        Send(connection, "QUEUED " + std::to_string(job.id) +
+                         " position=" + std::to_string(fQueue.size()));
+        return;
+    }
+
+    client.inJob = true;
+    if (keyword == "output") {
+        std::string output;
+        if (is >> output) client.pending.output = output;
+        else Send(connection, "ERROR output sin nombre");
+    }
+    else if (keyword == "seed") {
+        long seed = 0;
+        if (is >> seed) {
+            client.pending.seed = seed;
+            client.pending.hasSeed = true;
+        }
+        else {
+            Send(connection, "ERROR seed sin valor entero");
+        }
+    }
+    else if (keyword[0] == '/') {
+        client.pending.commands.push_back(line);
+    }
+    else {
+        Send(connection, "ERROR orden desconocida: " + keyword);
+    }
+}
+
+// =============================================================
+// Trabajos: un hijo por trabajo, a partir del estado inicializado
+// =============================================================
+G4bool SimulationServer::StartJobs()
+{
+    while (!fQueue.empty() && static_cast<G4int>(fRunning.size()) < fMaxJobs) {
+        const Job job = fQueue.front();
+        fQueue.pop_front();
+
+        int fds[2];
+        if (pipe(fds) != 0) {
+            Send(job.connection, "DONE " + std::to_string(job.id) + " status=error reason=pipe");
+            continue;
+        }
+
+        // Lo pendiente en los buffers no debe salir duplicado en el hijo
+        G4cout << std::flush;
+        std::fflush(nullptr);
+
+        const pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            fResultPipe = fds[1];
+            RunJob(job);
+            return true;
+        }
+
+        close(fds[1]);
+        if (pid < 0) {
+            close(fds[0]);
+            Send(job.connection, "DONE " + std::to_string(job.id) + " status=error reason=fork");
+            continue;
+        }
+
+        Running running;
+        running.job = job;
+        running.pid = pid;
+        running.pipe = fds[0];
+        running.started = Clock::now();
+        fRunning.push_back(running);
+
+        Send(job.connection, "STARTED " + std::to_string(job.id) + " pid=" + std::to_string(pid) +
+                             " wait_s=" + Fixed(Seconds(job.queued, running.started)));
+    }
+    return false;
+}
+
+void SimulationServer::RunJob(const Job& job)
+{
+    // El hijo solo conserva su tubería de resultado
+    if (fListen >= 0) close(fListen);
+    fListen = -1;
+    for (auto& connection : fConnections) {
+        if (connection.open && !fStdin) close(connection.in);
+        connection.open = false;
+    }
+    for (auto& running : fRunning) close(running.pipe);
+    fRunning.clear();
+    fQueue.clear();
+
+    // Log propio; stdin/stdout pueden ser el canal del protocolo
+    const std::string id = std::to_string(job.id);
+    const std::string log = "job_" + id + ".log";
+    const int logFd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (logFd >= 0) {
+        dup2(logFd, STDOUT_FILENO);
+        dup2(logFd, STDERR_FILENO);
+        close(logFd);
+    }
+    const int nullFd = open("/dev/null", O_RDONLY);
+    if (nullFd >= 0) {
+        dup2(nullFd, STDIN_FILENO);
+        close(nullFd);
+    }
+
+    const long seed = job.hasSeed ? job.seed : fBaseSeed + job.id;
+    G4Random::setTheSeed(seed);
+
+    auto output = OutputConfig::Instance();
+    output->SetFileName(job.output.empty() ? G4String("job_" + id) : job.output);
+
+    auto UImanager = G4UImanager::GetUIpointer();
+    auto runManager = G4RunManager::GetRunManager();
+
+    // Los eventos se cuentan por run nuevo tras cada comando
+    const G4Run* lastRun = runManager->GetCurrentRun();
+    G4int lastRunID = lastRun ? lastRun->GetRunID() : -1;
+    G4int events = 0;
+    G4double runSeconds = 0.;
+    G4int code = fCommandSucceeded;
+    G4String failed;
+
+    const auto start = Clock::now();
+    for (const auto& command : job.commands) {
+        const auto before = Clock::now();
+        code = UImanager->ApplyCommand(command);
+
+        const G4Run* run = runManager->GetCurrentRun();
+        if (run && run->GetRunID() != lastRunID) {
+            lastRunID = run->GetRunID();
+            events += run->GetNumberOfEvent();
+            runSeconds += Seconds(before, Clock::now());
+        }
+        if (code != fCommandSucceeded) {
+            failed = command;
+            break;
+        }
+    }
+    const G4double seconds = Seconds(start, Clock::now());
+
+    std::ostringstream result;
+    if (failed.empty()) result << "status=ok";
+    else                result << "status=error code=" << code << " command=\"" << failed << "\"";
+    result << " events=" << events
+           << " seconds=" << Fixed(seconds)
+           << " run_seconds=" << Fixed(runSeconds)
+           << " events_per_s=" << Fixed(runSeconds > 0. ? events / runSeconds : 0., 1)
+           << " output=" << output->GetOutputName() + output->GetExtension()
+           << " log=" << log
+           << " seed=" << seed;
+
+    G4cout << std::flush;
+    const std::string message = result.str();
+    if (write(fResultPipe, message.data(), message.size()) < 0)
+        G4cerr << "SimulationServer: no se pudo comunicar el resultado" << G4endl;
+    close(fResultPipe);
+    fResultPipe = -1;
+}
+
+void SimulationServer::Finish(std::size_t index)
+{
+    auto& running = fRunning[index];
+
+    char buffer[512];
+    const ssize_t n = read(running.pipe, buffer, sizeof(buffer));
+    if (n > 0) {
+        running.result.append(buffer, static_cast<std::size_t>(n));
+        return;
+    }
+
+    // Fin de la tubería: el hijo ha terminado (o ha muerto)
+    close(running.pipe);
+    int status = 0;
+    waitpid(running.pid, &status, 0);
+
+    const std::string id = std::to_string(running.job.id);
+    std::string line = "DONE " + id + " ";
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && !running.result.empty())
+        line += running.result;
+    else
+        line += "status=crash log=job_" + id + ".log";
+    line += " wall_s=" + Fixed(Seconds(running.started, Clock::now()));
+
+    Send(running.job.connection, line);
+    fDone++;
+    fRunning.erase(fRunning.begin() + static_cast<std::ptrdiff_t>(index));
+}
@@ -0,0 +1,78 @@
+#include "StackingAction.hh"
+#include "SiPMConfig.hh"
+#include "OpticsConfig.hh"
+#include "EventTriage.hh"
+
+#include "G4StackManager.hh"
+#include "G4Track.hh"
+#include "G4OpticalPhoton.hh"
+#include "G4OpProcessSubType.hh"
+#include "G4VProcess.hh"
+#include "Randomize.hh"
+
+StackingAction::StackingAction()
+: G4UserStackingAction(),
+  fTriage(EventTriage::Local())
+{}
+
+void StackingAction::PrepareNewEvent()
+{
+    auto sipm = SiPMConfig::Instance();
+    fCull = sipm->CullAtBirth();
+    fPDE  = sipm->GetPDE();
+    fSubEvent = OpticsConfig::Instance()->GetSubEventSize() > 0;
+
+    if (fTriage->active)
+        fTriage->BeginEvent();
+}
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+    if (track->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition())
+        return fUrgent;
+
+    if (!fReclassifying) {
+        // El PDE es independiente del camino del fotón: decidirlo ahora o al
+        // llegar da la misma estadística y los pesos no cambian
+        if (fCull && G4UniformRand() >= fPDE)
+            return fKill;
+
+        // Triaje: en espera hasta que se conozca el Edep del evento
+        if (fTriage->DefersOptics())
+            return fWaiting;
+    }
+
+#ifdef SCINT_SUBEVENT
+    // Solo el centellador tiene propiedades de centelleo: todos los
+    // fotones de G4Scintillation nacen en "Scintillator"
+    if (fSubEvent) {
+        const G4VProcess* creator = track->GetCreatorProcess();
+        if (creator && creator->GetProcessSubType() == fScintillation)
+            return static_cast<G4ClassificationOfNewTrack>(fSubEvent_0 + kOpticalSubEventType);
+    }
+#endif
+
+    return fUrgent;
+}
+
+void StackingAction::NewStage()
+{
+    // La pila urgente se ha vaciado: todo lo que no es fotón óptico ya se
+    // ha seguido y los fotones diferidos pasan ahora a la pila urgente
+    if (!fTriage->DefersOptics())
+        return;
+
+    if (!fTriage->ReleaseOptics(stackManager->GetNUrgentTrack())) {
+        stackManager->clear();
+        return;
+    }
+
+#ifdef SCINT_SUBEVENT
+    // Los fotones liberados van a la pila de sub-eventos
+    if (fSubEvent) {
+        fReclassifying = true;
+        stackManager->ReClassify();
+        fReclassifying = false;
+    }
+#endif
+}
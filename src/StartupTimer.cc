@@ -0,0 +1,214 @@
+#include "StartupTimer.hh"
+
+#include "G4ParticleDefinition.hh"
+#include "G4ProcessManager.hh"
+#include "G4Threading.hh"
+#include "G4VPhysicsConstructor.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <string>
+
+#include <sys/resource.h>
+
+namespace {
+
+G4double Seconds(StartupTimer::Clock::time_point begin, StartupTimer::Clock::time_point end)
+{
+    return std::chrono::duration<G4double>(end - begin).count();
+}
+
+// =============================================================
+// Proceso inerte: fuera de los bucles de DoIt (órdenes -1); solo
+// recibe PreparePhysicsTable y BuildPhysicsTable
+// =============================================================
+class TableMarker : public G4VProcess
+{
+public:
+    TableMarker() : G4VProcess("StartupTableMarker", fUserDefined) {}
+
+    void PreparePhysicsTable(const G4ParticleDefinition& particle) override
+    {
+        StartupTimer::Instance()->MarkTables(&particle, false);
+    }
+
+    void BuildPhysicsTable(const G4ParticleDefinition& particle) override
+    {
+        StartupTimer::Instance()->MarkTables(&particle, true);
+    }
+
+    G4double AlongStepGetPhysicalInteractionLength(const G4Track&, G4double, G4double,
+                                                   G4double&, G4GPILSelection*) override
+    { return DBL_MAX; }
+
+    G4double AtRestGetPhysicalInteractionLength(const G4Track&, G4ForceCondition* condition) override
+    {
+        *condition = NotForced;
+        return DBL_MAX;
+    }
+
+    G4double PostStepGetPhysicalInteractionLength(const G4Track&, G4double,
+                                                  G4ForceCondition* condition) override
+    {
+        *condition = NotForced;
+        return DBL_MAX;
+    }
+
+    G4VParticleChange* AlongStepDoIt(const G4Track& track, const G4Step&) override
+    {
+        pParticleChange->Initialize(track);
+        return pParticleChange;
+    }
+
+    G4VParticleChange* AtRestDoIt(const G4Track& track, const G4Step&) override
+    {
+        pParticleChange->Initialize(track);
+        return pParticleChange;
+    }
+
+    G4VParticleChange* PostStepDoIt(const G4Track& track, const G4Step&) override
+    {
+        pParticleChange->Initialize(track);
+        return pParticleChange;
+    }
+};
+
+// Se registra la última: el marcador queda al final de cada lista
+class TableMarkerPhysics : public G4VPhysicsConstructor
+{
+public:
+    TableMarkerPhysics() : G4VPhysicsConstructor("StartupTableMarkers") {}
+
+    void ConstructParticle() override {}
+
+    void ConstructProcess() override
+    {
+        auto particleIterator = GetParticleIterator();
+        particleIterator->reset();
+        while ((*particleIterator)()) {
+            auto processManager = particleIterator->value()->GetProcessManager();
+            if (processManager)
+                processManager->AddProcess(new TableMarker(), -1, -1, -1);
+        }
+    }
+};
+
+}
+
+// =============================================================
+// Fases y detalles
+// =============================================================
+StartupTimer* StartupTimer::Instance()
+{
+    // Se crea al principio de main: es el origen de tiempos
+    static StartupTimer* instance = new StartupTimer();
+    return instance;
+}
+
+StartupTimer::StartupTimer()
+: fStart(Clock::now()),
+  fPhaseStart(fStart),
+  fLastTableMark(fStart)
+{}
+
+void StartupTimer::Phase(const G4String& name)
+{
+    if (fReported) return;
+
+    const auto now = Clock::now();
+    if (!fPhaseName.empty())
+        fPhases.emplace_back(fPhaseName, Seconds(fPhaseStart, now));
+    fPhaseName = name;
+    fPhaseStart = now;
+}
+
+void StartupTimer::AddDetail(const G4String& name, G4double seconds)
+{
+    if (fReported || !G4Threading::IsMasterThread()) return;
+    fDetails.emplace_back(name, seconds);
+}
+
+StartupTimer::Measure::~Measure()
+{
+    StartupTimer::Instance()->AddDetail(fName, Seconds(fStart, Clock::now()));
+}
+
+// =============================================================
+// Tablas de física
+// =============================================================
+void StartupTimer::MarkTables(const G4ParticleDefinition* particle, G4bool built)
+{
+    // Los workers reconstruyen sus tablas a partir de las del maestro
+    if (fReported || !G4Threading::IsMasterThread()) return;
+
+    // PreparePhysicsTable de todas las partículas precede a la
+    // construcción: cada partícula se mide desde la marca anterior
+    const auto now = Clock::now();
+    if (built)
+        fTables[particle->GetParticleName()] += Seconds(fLastTableMark, now);
+    fLastTableMark = now;
+}
+
+G4VPhysicsConstructor* StartupTimer::CreateMarkerPhysics()
+{
+    return new TableMarkerPhysics();
+}
+
+// =============================================================
+// Informe
+// =============================================================
+void StartupTimer::Report()
+{
+    if (fReported) return;
+    Phase("");
+    fReported = true;
+
+    char line[128];
+    auto print = [&line](G4int indent, const G4String& name, G4double seconds) {
+        std::snprintf(line, sizeof(line), "%*s%-*s %9.3f s\n",
+                      indent, "", 38 - indent, name.c_str(), seconds);
+        G4cout << line;
+    };
+
+    G4cout << "\n================ ARRANQUE ================\n";
+    G4double total = 0.;
+    for (const auto& phase : fPhases) {
+        print(2, phase.first, phase.second);
+        total += phase.second;
+    }
+
+    if (!fDetails.empty() || !fTables.empty())
+        G4cout << "  de las cuales:\n";
+    for (const auto& detail : fDetails)
+        print(4, detail.first, detail.second);
+
+    if (!fTables.empty()) {
+        G4double tables = 0.;
+        std::vector<std::pair<G4String, G4double>> ranking(fTables.begin(), fTables.end());
+        for (const auto& entry : ranking) tables += entry.second;
+        std::sort(ranking.begin(), ranking.end(),
+                  [](const auto& a, const auto& b) { return a.second > b.second; });
+
+        print(4, "tablas de física", tables);
+        const std::size_t shown = std::min<std::size_t>(ranking.size(), 5);
+        G4double rest = tables;
+        for (std::size_t i = 0; i < shown; ++i) {
+            const G4String name = ranking[i].first == "neutron" ? G4String("neutron (datos HP)")
+                                                                : ranking[i].first;
+            print(6, name, ranking[i].second);
+            rest -= ranking[i].second;
+        }
+        if (ranking.size() > shown)
+            print(6, "resto (" + std::to_string(ranking.size() - shown) + " partículas)", rest);
+    }
+
+    print(2, "total", total);
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    std::snprintf(line, sizeof(line), "  %-36s %9.1f MB\n", "memoria (pico RSS)", usage.ru_maxrss / 1024.);
+    G4cout << line
+           << "==========================================" << G4endl;
+}
@@ -0,0 +1,35 @@
+#include "SteppingAction.hh"
+#include "EventAction.hh"
+#include "Profiler.hh"
+#include "PhotonPolicy.hh"
+#include "EventTriage.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+
+SteppingAction::SteppingAction(EventAction* eventAction)
+: G4UserSteppingAction(),
+  fEventAction(eventAction),
+  fProfile(Profiler::Local()),
+  fPhotons(PhotonPolicy::Local()),
+  fTriage(EventTriage::Local())
+{}
+
+void SteppingAction::UserSteppingAction(const G4Step* step)
+{
+    // Con --bias el peso del primario cambia en cada step por el grafeno
+    const G4Track* track = step->GetTrack();
+    if (track->GetTrackID() == 1)
+        fEventAction->SetPrimaryWeight(track->GetWeight());
+
+    if (fTriage->abortOnEscape)
+        fTriage->Apply(step);
+
+    if (fPhotons->active)
+        fPhotons->Apply(step);
+
+#ifdef SCINT_PROFILING
+    if (fProfile->level != ProfileLevel::OFF)
+        fProfile->RecordStep(step);
+#endif
+}
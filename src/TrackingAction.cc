@@ -0,0 +1,13 @@
+#include "TrackingAction.hh"
+#include "Profiler.hh"
+
+TrackingAction::TrackingAction()
+: G4UserTrackingAction(),
+  fProfile(Profiler::Local())
+{}
+
+void TrackingAction::PreUserTrackingAction(const G4Track* track)
+{
+    if (fProfile->level != ProfileLevel::OFF)
+        fProfile->StartTrack(track);
+}
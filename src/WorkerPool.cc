@@ -0,0 +1,134 @@
+#include "WorkerPool.hh"
+#include "OutputConfig.hh"
+#include "OutputMerge.hh"
+
+#include <cstdio>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+WorkerPool::WorkerPool(G4int nWorkers)
+    : fNWorkers(nWorkers)
+{}
+
+// =============================================================
+// fork() de los hijos. Cada uno escribe su log en worker_<i>.log y, al
+// terminar, su nombre base de salida por una tubería.
+// =============================================================
+G4bool WorkerPool::Fork()
+{
+    // Lo pendiente en los buffers no debe salir duplicado en los hijos
+    G4cout << std::flush;
+    std::fflush(nullptr);
+
+    std::vector<pid_t> pids(fNWorkers, -1);
+    std::vector<G4int> pipes(fNWorkers, -1);
+
+    for (G4int i = 0; i < fNWorkers; ++i) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            G4cerr << "WorkerPool: no se pudo crear la tubería del proceso " << i << G4endl;
+            fChildrenOk = false;
+            break;
+        }
+
+        const pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            for (G4int j = 0; j < i; ++j) close(pipes[j]);
+
+            fIndex = i;
+            fPipe = fds[1];
+
+            const std::string log = "worker_" + std::to_string(i) + ".log";
+            const int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd >= 0) {
+                dup2(fd, STDOUT_FILENO);
+                dup2(fd, STDERR_FILENO);
+                close(fd);
+            }
+            return true;
+        }
+
+        close(fds[1]);
+        if (pid < 0) {
+            G4cerr << "WorkerPool: fork() falló para el proceso " << i << G4endl;
+            close(fds[0]);
+            fChildrenOk = false;
+            break;
+        }
+        pids[i] = pid;
+        pipes[i] = fds[0];
+    }
+
+    // ------------------------------------------------------------
+    // Padre: nombres de salida y estado de cada hijo
+    // ------------------------------------------------------------
+    fChildOutputs.assign(fNWorkers, "");
+    for (G4int i = 0; i < fNWorkers; ++i) {
+        if (pids[i] < 0) continue;
+
+        std::string name;
+        char buffer[256];
+        ssize_t n;
+        while ((n = read(pipes[i], buffer, sizeof(buffer))) > 0)
+            name.append(buffer, static_cast<std::size_t>(n));
+        close(pipes[i]);
+
+        int status = 0;
+        waitpid(pids[i], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || name.empty()) {
+            G4cerr << "WorkerPool: el proceso " << i << " terminó con error (ver worker_"
+                   << i << ".log)" << G4endl;
+            fChildrenOk = false;
+        }
+        fChildOutputs[i] = name;
+    }
+
+    return false;
+}
+
+void WorkerPool::FinishChild()
+{
+    if (fPipe < 0) return;
+
+    // La salida del hijo lleva el sufijo _w<i>; el padre necesita la base
+    // y el formato, que la macro puede haber cambiado (/output/...)
+    auto output = OutputConfig::Instance();
+    const std::string message =
+        (output->GetFormat() == OutputFormat::COLUMNAR ? "columnar\n" : "root\n") +
+        std::string(output->GetFileName());
+    if (write(fPipe, message.data(), message.size()) < 0)
+        G4cerr << "WorkerPool: no se pudo comunicar la salida al padre" << G4endl;
+    close(fPipe);
+    fPipe = -1;
+}
+
+// =============================================================
+// Fusión en orden de proceso, que es el orden global de los eventos
+// =============================================================
+G4bool WorkerPool::Merge()
+{
+    if (!fChildrenOk || fChildOutputs.empty()) return false;
+
+    // Cada hijo envía "formato\nnombre base"
+    const G4String message = fChildOutputs[0];
+    const std::size_t newline = message.find('\n');
+    const G4String baseName = message.substr(newline + 1);
+    OutputConfig::Instance()->SetFormat(message.substr(0, newline));
+
+    std::vector<G4String> inputs;
+    for (G4int w = 0; w < fNWorkers; ++w) {
+        if (fChildOutputs[w] != message) {
+            G4cerr << "WorkerPool: los procesos usaron salidas distintas" << G4endl;
+            return false;
+        }
+        inputs.push_back(baseName + "_w" + std::to_string(w));
+    }
+
+    if (!MergeOutputs(inputs, baseName)) return false;
+    RemoveOutputs(inputs);
+    return true;
+}